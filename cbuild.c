@@ -139,7 +139,7 @@ int main( int argc, const char** argv ) {
                     "clang", "src/sources.c",
                     "vendor/native/libraylib.a",
                     "-Isrc", "-Iraylib/src",
-                    "-static-libgcc", "-O2",
+                    "-static-libgcc", "-O2", "-ffp-contract=off",
                     #if defined(PLATFORM_WINDOWS)
                         "-lraylib", "-lgdi32", "-lwinmm", "-lopengl32",
                         "-fuse-ld=lld", "-Wl,--subsystem,windows",
@@ -153,7 +153,7 @@ int main( int argc, const char** argv ) {
                     "clang", "src/sources.c",
                     "vendor/native/libraylib.a",
                     "-Isrc", "-Iraylib/src", "-DDEBUG",
-                    "-static-libgcc", "-O0", "-g",
+                    "-static-libgcc", "-O0", "-g", "-ffp-contract=off",
                     #if defined(PLATFORM_WINDOWS)
                         "-fuse-ld=lld", "-Wl,/debug", "-gcodeview",
                         "-lraylib", "-lgdi32", "-lwinmm", "-lopengl32",
@@ -199,7 +199,7 @@ int main( int argc, const char** argv ) {
                     "-o", build_path,
                     "src/sources.c",
                     "vendor/web/libraylib.a",
-                    "-Os", "-Wall", "-Wextra", "-Werror=vla",
+                    "-Os", "-ffp-contract=off", "-Wall", "-Wextra", "-Werror=vla",
                     "-Werror", "-Isrc", "-Iraylib/src",
                     "-s", "USE_GLFW=3",
                     "-s", max_mem,
@@ -216,7 +216,7 @@ int main( int argc, const char** argv ) {
                     "-o", build_path,
                     "src/sources.c",
                     "vendor/web/libraylib.a",
-                    "-g", "-O0", "-Wall", "-Wextra", "-Werror=vla",
+                    "-g", "-O0", "-ffp-contract=off", "-Wall", "-Wextra", "-Werror=vla",
                     "-Isrc", "-Iraylib/src", "-DDEBUG",
                     "-s", "USE_GLFW=3",
                     "-s", max_mem,
@@ -330,10 +330,15 @@ int compile_raylib( enum Target target ) {
     switch( target ) {
         case T_NATIVE: {
             cb_info( "compiling raylib for native platform . . ." );
+            // NOTE(alicia): the tick path calls raylib math and
+            // collision functions so raylib has to be built with
+            // the same contraction rules as the game for replays
+            // to stay deterministic.
             Command cmd =
                 command_new(
                     "make", "-C", "./raylib/src", "-B",
                     "PLATFORM=PLATFORM_DESKTOP",
+                    "CUSTOM_CFLAGS=-ffp-contract=off",
                     "CC=clang", "RAYLIB_RELEASE_PATH=../../vendor/native" );
             PID pid = process_exec( cmd, false, NULL, NULL, NULL, NULL );
             int res = process_wait( pid );
@@ -348,6 +353,7 @@ int compile_raylib( enum Target target ) {
                 command_new(
                     "make", "-C", "./raylib/src", "-B",
                     "PLATFORM=PLATFORM_WEB",
+                    "CUSTOM_CFLAGS=-ffp-contract=off",
                     "RAYLIB_RELEASE_PATH=../../vendor/web" );
             PID pid = process_exec( cmd, false, NULL, NULL, NULL, NULL );
             int res = process_wait( pid );
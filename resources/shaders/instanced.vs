@@ -0,0 +1,17 @@
+#version 330
+
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in vec4 vertexColor;
+in mat4 instanceTransform;
+
+uniform mat4 mvp;
+
+out vec2 fragTexCoord;
+out vec4 fragColor;
+
+void main() {
+    fragTexCoord = vertexTexCoord;
+    fragColor    = vertexColor;
+    gl_Position  = mvp * instanceTransform * vec4( vertexPosition, 1.0 );
+}
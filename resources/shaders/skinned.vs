@@ -0,0 +1,39 @@
+#version 330
+
+#define MAX_BONES 64
+
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in vec4 vertexColor;
+// pinned past raylib's default attribute locations,
+// must match SKIN_GPU_BONE_*_LOCATION in skin.h
+layout(location = 6) in vec4 vertexBoneIds;
+layout(location = 7) in vec4 vertexBoneWeights;
+
+uniform mat4 mvp;
+// three rows of an affine transform per bone
+uniform vec4 boneRows[MAX_BONES * 3];
+
+out vec2 fragTexCoord;
+out vec4 fragColor;
+
+void main() {
+    vec4 row0 = vec4( 0.0 );
+    vec4 row1 = vec4( 0.0 );
+    vec4 row2 = vec4( 0.0 );
+    for( int i = 0; i < 4; ++i ) {
+        int   bone   = int( vertexBoneIds[i] ) * 3;
+        float weight = vertexBoneWeights[i];
+        row0 += boneRows[bone + 0] * weight;
+        row1 += boneRows[bone + 1] * weight;
+        row2 += boneRows[bone + 2] * weight;
+    }
+
+    vec4 position = vec4( vertexPosition, 1.0 );
+    vec3 skinned  = vec3(
+        dot( row0, position ), dot( row1, position ), dot( row2, position ) );
+
+    fragTexCoord = vertexTexCoord;
+    fragColor    = vertexColor;
+    gl_Position  = mvp * vec4( skinned, 1.0 );
+}
@@ -0,0 +1,300 @@
+/**
+ * @file   actor.c
+ * @brief  Capsule actors.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 18, 2026
+*/
+#include "actor.h"
+#include "job.h"
+#include "mathex.h"
+// IWYU pragma: begin_keep
+#include <string.h>
+// IWYU pragma: end_keep
+
+static f32 actor_kind_inverse_mass( enum ActorKind kind ) {
+    switch( kind ) {
+        case ACTOR_NPC:       return 1.0f;
+        case ACTOR_PROP:      return 4.0f;
+        case ACTOR_GHOST:     return 0.0f;
+        case ACTOR_KINEMATIC: return 0.0f;
+    }
+    return 0.0f;
+}
+
+b32 actor_pool_create( struct ActorPool* out_pool, u32 capacity ) {
+    memset( out_pool, 0, sizeof(*out_pool) );
+    if( !capacity ) {
+        return false;
+    }
+
+    out_pool->capacity     = capacity;
+    out_pool->position_x   = MemAlloc( sizeof(f32) * capacity );
+    out_pool->position_y   = MemAlloc( sizeof(f32) * capacity );
+    out_pool->position_z   = MemAlloc( sizeof(f32) * capacity );
+    out_pool->velocity_x   = MemAlloc( sizeof(f32) * capacity );
+    out_pool->velocity_y   = MemAlloc( sizeof(f32) * capacity );
+    out_pool->velocity_z   = MemAlloc( sizeof(f32) * capacity );
+    out_pool->radius       = MemAlloc( sizeof(f32) * capacity );
+    out_pool->height       = MemAlloc( sizeof(f32) * capacity );
+    out_pool->inverse_mass = MemAlloc( sizeof(f32) * capacity );
+    out_pool->kind         = MemAlloc( sizeof(u8)  * capacity );
+    out_pool->flags        = MemAlloc( sizeof(u8)  * capacity );
+    out_pool->sweep_order  = MemAlloc( sizeof(u32) * capacity );
+    out_pool->sweep_min    = MemAlloc( sizeof(f32) * capacity );
+    out_pool->sweep_max    = MemAlloc( sizeof(f32) * capacity );
+
+    out_pool->level_queries = MemAlloc( sizeof(struct CapsuleQuery) * capacity );
+    out_pool->level_results = MemAlloc( sizeof(struct CollisionResult) * capacity );
+    out_pool->level_owners  = MemAlloc( sizeof(u32) * capacity );
+
+    out_pool->pair_capacity = capacity;
+    out_pool->pairs    = MemAlloc( sizeof(struct ActorPair) * out_pool->pair_capacity );
+    out_pool->contacts =
+        MemAlloc( sizeof(struct CollisionResult) * out_pool->pair_capacity );
+    return true;
+}
+void actor_pool_destroy( struct ActorPool* pool ) {
+    MemFree( pool->position_x );
+    MemFree( pool->position_y );
+    MemFree( pool->position_z );
+    MemFree( pool->velocity_x );
+    MemFree( pool->velocity_y );
+    MemFree( pool->velocity_z );
+    MemFree( pool->radius );
+    MemFree( pool->height );
+    MemFree( pool->inverse_mass );
+    MemFree( pool->kind );
+    MemFree( pool->flags );
+    MemFree( pool->sweep_order );
+    MemFree( pool->sweep_min );
+    MemFree( pool->sweep_max );
+    MemFree( pool->level_queries );
+    MemFree( pool->level_results );
+    MemFree( pool->level_owners );
+    MemFree( pool->pairs );
+    MemFree( pool->contacts );
+    memset( pool, 0, sizeof(*pool) );
+}
+void actor_pool_clear( struct ActorPool* pool ) {
+    pool->count         = 0;
+    pool->pair_count    = 0;
+    pool->contact_count = 0;
+}
+
+u32 actor_spawn(
+    struct ActorPool* pool, enum ActorKind kind,
+    Vector3 position, f32 radius, f32 height
+) {
+    if( pool->count >= pool->capacity ) {
+        return U32_MAX;
+    }
+
+    u32 actor = pool->count++;
+    pool->position_x[actor]   = position.x;
+    pool->position_y[actor]   = position.y;
+    pool->position_z[actor]   = position.z;
+    pool->velocity_x[actor]   = 0.0f;
+    pool->velocity_y[actor]   = 0.0f;
+    pool->velocity_z[actor]   = 0.0f;
+    pool->radius[actor]       = radius;
+    pool->height[actor]       = height;
+    pool->inverse_mass[actor] = actor_kind_inverse_mass( kind );
+    pool->kind[actor]         = (u8)kind;
+    pool->flags[actor]        = 0;
+
+    pool->sweep_order[actor] = actor;
+    return actor;
+}
+void actor_despawn( struct ActorPool* pool, u32 actor ) {
+    if( actor >= pool->count ) {
+        return;
+    }
+
+    u32 last = --pool->count;
+    if( actor != last ) {
+        pool->position_x[actor]   = pool->position_x[last];
+        pool->position_y[actor]   = pool->position_y[last];
+        pool->position_z[actor]   = pool->position_z[last];
+        pool->velocity_x[actor]   = pool->velocity_x[last];
+        pool->velocity_y[actor]   = pool->velocity_y[last];
+        pool->velocity_z[actor]   = pool->velocity_z[last];
+        pool->radius[actor]       = pool->radius[last];
+        pool->height[actor]       = pool->height[last];
+        pool->inverse_mass[actor] = pool->inverse_mass[last];
+        pool->kind[actor]         = pool->kind[last];
+        pool->flags[actor]        = pool->flags[last];
+    }
+
+    // NOTE(alicia): drop removed actor from sweep order and
+    // rename last actor, keeps the rest of the order intact.
+    u32 write = 0;
+    for( u32 i = 0; i <= last; ++i ) {
+        u32 index = pool->sweep_order[i];
+        if( index == actor ) {
+            continue;
+        }
+        pool->sweep_order[write++] = index == last ? actor : index;
+    }
+    pool->pair_count = 0;
+}
+
+Vector3 actor_position( const struct ActorPool* pool, u32 actor ) {
+    return v3(
+        pool->position_x[actor], pool->position_y[actor], pool->position_z[actor] );
+}
+Vector3 actor_velocity( const struct ActorPool* pool, u32 actor ) {
+    return v3(
+        pool->velocity_x[actor], pool->velocity_y[actor], pool->velocity_z[actor] );
+}
+void actor_set_position( struct ActorPool* pool, u32 actor, Vector3 position ) {
+    pool->position_x[actor] = position.x;
+    pool->position_y[actor] = position.y;
+    pool->position_z[actor] = position.z;
+}
+void actor_set_velocity( struct ActorPool* pool, u32 actor, Vector3 velocity ) {
+    pool->velocity_x[actor] = velocity.x;
+    pool->velocity_y[actor] = velocity.y;
+    pool->velocity_z[actor] = velocity.z;
+}
+void actor_capsule(
+    const struct ActorPool* pool, u32 actor, Vector3* out_start, Vector3* out_end
+) {
+    *out_start = actor_position( pool, actor );
+    *out_end   = *out_start;
+    out_end->y += pool->height[actor];
+}
+b32 actor_collides_level( const struct ActorPool* pool, u32 actor ) {
+    return pool->kind[actor] == ACTOR_NPC || pool->kind[actor] == ACTOR_PROP;
+}
+
+u32 actor_pool_broadphase( struct ActorPool* pool ) {
+    pool->pair_count = 0;
+
+    for( u32 i = 0; i < pool->count; ++i ) {
+        pool->sweep_min[i] = pool->position_x[i] - pool->radius[i];
+        pool->sweep_max[i] = pool->position_x[i] + pool->radius[i];
+    }
+
+    u32* order = pool->sweep_order;
+    for( u32 i = 1; i < pool->count; ++i ) {
+        u32 index = order[i];
+        f32 key   = pool->sweep_min[index];
+        u32 j     = i;
+        while( j && pool->sweep_min[order[j - 1]] > key ) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = index;
+    }
+
+    for( u32 i = 0; i < pool->count; ++i ) {
+        u32 a = order[i];
+        if( pool->kind[a] == ACTOR_GHOST ) {
+            continue;
+        }
+
+        f32 a_max_x = pool->sweep_max[a];
+        f32 a_min_y = pool->position_y[a];
+        f32 a_max_y = a_min_y + pool->height[a];
+        f32 a_min_z = pool->position_z[a] - pool->radius[a];
+        f32 a_max_z = pool->position_z[a] + pool->radius[a];
+
+        for( u32 j = i + 1; j < pool->count; ++j ) {
+            u32 b = order[j];
+            if( pool->sweep_min[b] > a_max_x ) {
+                break;
+            }
+            if(
+                pool->kind[b] == ACTOR_GHOST ||
+                ( pool->inverse_mass[a] == 0.0f && pool->inverse_mass[b] == 0.0f )
+            ) {
+                continue;
+            }
+
+            f32 b_min_y = pool->position_y[b];
+            if( b_min_y > a_max_y || b_min_y + pool->height[b] < a_min_y ) {
+                continue;
+            }
+            f32 b_min_z = pool->position_z[b] - pool->radius[b];
+            if( b_min_z > a_max_z || b_min_z + pool->radius[b] * 2.0f < a_min_z ) {
+                continue;
+            }
+
+            if( pool->pair_count >= pool->pair_capacity ) {
+                pool->pair_capacity *= 2;
+                pool->pairs = MemRealloc(
+                    pool->pairs, sizeof(struct ActorPair) * pool->pair_capacity );
+                pool->contacts = MemRealloc(
+                    pool->contacts,
+                    sizeof(struct CollisionResult) * pool->pair_capacity );
+            }
+            struct ActorPair* pair = pool->pairs + pool->pair_count++;
+            pair->a = a;
+            pair->b = b;
+        }
+    }
+
+    return pool->pair_count;
+}
+
+static void actor_pair_range( void* params, u32 begin, u32 end, u32 thread ) {
+    unused( thread );
+    struct ActorPool* pool = params;
+    for( u32 i = begin; i < end; ++i ) {
+        struct ActorPair* pair = pool->pairs + i;
+
+        Vector3 a_start, a_end, b_start, b_end;
+        actor_capsule( pool, pair->a, &a_start, &a_end );
+        actor_capsule( pool, pair->b, &b_start, &b_end );
+
+        pool->contacts[i] = collision_capsule_capsule(
+            a_start, a_end, pool->radius[pair->a],
+            b_start, b_end, pool->radius[pair->b] );
+    }
+}
+u32 actor_pool_resolve( struct ActorPool* pool ) {
+    pool->contact_count = 0;
+    job_parallel_for( pool->pair_count, ACTOR_PAIR_BATCH, actor_pair_range, pool );
+
+    // NOTE(alicia): contacts are tested against positions from the
+    // start of the pass, corrections are applied serially afterwards
+    // since an actor can be in many pairs.
+    for( u32 i = 0; i < pool->pair_count; ++i ) {
+        struct CollisionResult* contact = pool->contacts + i;
+        if( !contact->hit ) {
+            continue;
+        }
+        u32 a = pool->pairs[i].a;
+        u32 b = pool->pairs[i].b;
+
+        f32 a_weight = pool->inverse_mass[a];
+        f32 b_weight = pool->inverse_mass[b];
+        f32 total    = a_weight + b_weight;
+        if( total == 0.0f || Vector3LengthSqr( contact->normal ) == 0.0f ) {
+            continue;
+        }
+        pool->contact_count++;
+
+        // NOTE(alicia): normal points from b towards a.
+        Vector3 normal     = contact->normal;
+        Vector3 correction = Vector3Scale( normal, contact->distance / total );
+        actor_set_position( pool, a, Vector3Add(
+            actor_position( pool, a ), Vector3Scale( correction, a_weight ) ) );
+        actor_set_position( pool, b, Vector3Subtract(
+            actor_position( pool, b ), Vector3Scale( correction, b_weight ) ) );
+
+        Vector3 a_velocity = actor_velocity( pool, a );
+        Vector3 b_velocity = actor_velocity( pool, b );
+        f32 approach = Vector3DotProduct(
+            Vector3Subtract( a_velocity, b_velocity ), normal );
+        if( approach < 0.0f ) {
+            Vector3 impulse = Vector3Scale( normal, -approach / total );
+            actor_set_velocity( pool, a,
+                Vector3Add( a_velocity, Vector3Scale( impulse, a_weight ) ) );
+            actor_set_velocity( pool, b,
+                Vector3Subtract( b_velocity, Vector3Scale( impulse, b_weight ) ) );
+        }
+    }
+
+    return pool->contact_count;
+}
@@ -0,0 +1,98 @@
+#if !defined(ACTOR_H)
+#define ACTOR_H
+/**
+ * @file   actor.h
+ * @brief  Capsule actors.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 18, 2026
+*/
+#include "common.h"
+#include "physics.h"
+
+#define ACTOR_CAPACITY (4096)
+/// Actor pairs resolved per job.
+#define ACTOR_PAIR_BATCH (64)
+/// Contact normals steeper than this count as standing on ground.
+#define ACTOR_GROUND_NORMAL_Y (0.7f)
+
+#define ACTOR_FLAG_GROUNDED (1 << 0)
+
+enum ActorKind {
+    /// Collides with level and other actors.
+    ACTOR_NPC,
+    /// Collides with level and other actors, pushed around easily.
+    ACTOR_PROP,
+    /// Moved by game code, collides with nothing.
+    ACTOR_GHOST,
+    /// Moved by game code, pushes other actors but is never pushed.
+    ACTOR_KINEMATIC,
+};
+
+struct ActorPair {
+    u32 a;
+    u32 b;
+};
+
+/// Actors are stored as SoA arrays, removal swaps with last actor.
+struct ActorPool {
+    u32 count;
+    u32 capacity;
+
+    f32* position_x;
+    f32* position_y;
+    f32* position_z;
+    f32* velocity_x;
+    f32* velocity_y;
+    f32* velocity_z;
+    f32* radius;
+    f32* height;
+    f32* inverse_mass;
+    u8*  kind;
+    u8*  flags;
+
+    // NOTE(alicia): sweep order persists between frames so
+    // insertion sort only has to fix up actors that moved.
+    u32* sweep_order;
+    f32* sweep_min;
+    f32* sweep_max;
+
+    // NOTE(alicia): level collision scratch, sized by capacity
+    // so stepping actors never allocates.
+    struct CapsuleQuery*    level_queries;
+    struct CollisionResult* level_results;
+    u32*                    level_owners;
+
+    struct ActorPair*       pairs;
+    struct CollisionResult* contacts;
+    u32 pair_count;
+    u32 pair_capacity;
+    u32 contact_count;
+};
+
+b32  actor_pool_create( struct ActorPool* out_pool, u32 capacity );
+void actor_pool_destroy( struct ActorPool* pool );
+void actor_pool_clear( struct ActorPool* pool );
+
+/// Position is bottom of capsule. Returns U32_MAX if pool is full.
+u32  actor_spawn(
+    struct ActorPool* pool, enum ActorKind kind,
+    Vector3 position, f32 radius, f32 height );
+/// Last actor is moved into removed slot.
+void actor_despawn( struct ActorPool* pool, u32 actor );
+
+Vector3 actor_position( const struct ActorPool* pool, u32 actor );
+Vector3 actor_velocity( const struct ActorPool* pool, u32 actor );
+void    actor_set_position( struct ActorPool* pool, u32 actor, Vector3 position );
+void    actor_set_velocity( struct ActorPool* pool, u32 actor, Vector3 velocity );
+void    actor_capsule(
+    const struct ActorPool* pool, u32 actor, Vector3* out_start, Vector3* out_end );
+/// Does actor collide with level geometry.
+b32     actor_collides_level( const struct ActorPool* pool, u32 actor );
+
+/// Sweep-and-prune on x axis, writes overlapping pairs. Returns pair count.
+u32 actor_pool_broadphase( struct ActorPool* pool );
+/// Test broadphase pairs across job system workers, then push
+/// overlapping actors apart by inverse mass. Returns contact count.
+u32 actor_pool_resolve( struct ActorPool* pool );
+
+#endif /* header guard */
@@ -0,0 +1,496 @@
+/**
+ * @file   anim.c
+ * @brief  Animation sampling.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 19, 2026
+*/
+#include "anim.h"
+#include "mathex.h"
+// IWYU pragma: begin_keep
+#include <string.h>
+// IWYU pragma: end_keep
+#if defined(__x86_64__) || defined(__SSE__)
+    #include <xmmintrin.h>
+    #define ANIM_SSE
+#endif
+
+#define ANIM_SQRT2 (1.41421356f)
+#define ANIM_Q15_MAX (32767.0f)
+
+// NOTE(alicia): largest component is dropped and rebuilt from the
+// other three, which all fit in [-1/sqrt2, 1/sqrt2]. Each gets 15 bits,
+// low bits of first two hold index of dropped component.
+static void anim_rotation_encode( Quaternion q, u16* out ) {
+    f32 c[4] = { q.x, q.y, q.z, q.w };
+    u32 largest = 0;
+    for( u32 i = 1; i < 4; ++i ) {
+        if( absf( c[i] ) > absf( c[largest] ) ) {
+            largest = i;
+        }
+    }
+    f32 sign = c[largest] < 0.0f ? -1.0f : 1.0f;
+
+    u32 slot = 0;
+    for( u32 i = 0; i < 4; ++i ) {
+        if( i == largest ) {
+            continue;
+        }
+        f32 n = Clamp( c[i] * sign * ANIM_SQRT2 * 0.5f + 0.5f, 0.0f, 1.0f );
+        out[slot++] = (u16)( (u16)( n * ANIM_Q15_MAX + 0.5f ) << 1 );
+    }
+    out[0] |= (u16)( largest & 1 );
+    out[1] |= (u16)( ( largest >> 1 ) & 1 );
+}
+static void anim_rotation_decode( const u16* in, f32* out ) {
+    u32 largest = ( in[0] & 1 ) | ( ( in[1] & 1 ) << 1 );
+    u32 slot    = 0;
+    f32 sum     = 0.0f;
+    for( u32 i = 0; i < 4; ++i ) {
+        if( i == largest ) {
+            continue;
+        }
+        f32 n  = (f32)( in[slot++] >> 1 ) / ANIM_Q15_MAX;
+        out[i] = ( n - 0.5f ) * 2.0f / ANIM_SQRT2;
+        sum   += out[i] * out[i];
+    }
+    out[largest] = sqrtf( sum < 1.0f ? 1.0f - sum : 0.0f );
+}
+static void anim_vector_encode( Vector3 v, Vector3 min, Vector3 step, u16* out ) {
+    f32 c[3]    = { v.x - min.x, v.y - min.y, v.z - min.z };
+    f32 steps[3] = { step.x, step.y, step.z };
+    for( u32 i = 0; i < 3; ++i ) {
+        f32 n  = steps[i] > 0.0f ? c[i] / steps[i] + 0.5f : 0.0f;
+        out[i] = (u16)Clamp( n, 0.0f, (f32)U16_MAX );
+    }
+}
+
+static void anim_key_decode(
+    const struct AnimClip* clip, enum AnimChannel channel, const u16* in, f32* out
+) {
+    Vector3 min, step;
+    switch( channel ) {
+        case ANIM_CHANNEL_ROTATION: {
+            anim_rotation_decode( in, out );
+        } return;
+        case ANIM_CHANNEL_TRANSLATION: {
+            min  = clip->translation_min;
+            step = clip->translation_step;
+        } break;
+        case ANIM_CHANNEL_SCALE:
+        default: {
+            min  = clip->scale_min;
+            step = clip->scale_step;
+        } break;
+    }
+    out[0] = min.x + (f32)in[0] * step.x;
+    out[1] = min.y + (f32)in[1] * step.y;
+    out[2] = min.z + (f32)in[2] * step.z;
+    out[3] = 0.0f;
+}
+static void anim_key_lerp(
+    enum AnimChannel channel, const f32* a, const f32* b, f32 t, f32* out
+) {
+    f32 sign = 1.0f;
+    if( channel == ANIM_CHANNEL_ROTATION ) {
+        f32 dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+        sign = dot < 0.0f ? -1.0f : 1.0f;
+    }
+    f32 length = 0.0f;
+    for( u32 i = 0; i < 4; ++i ) {
+        out[i]  = a[i] + ( b[i] * sign - a[i] ) * t;
+        length += out[i] * out[i];
+    }
+    if( channel == ANIM_CHANNEL_ROTATION && length > 0.0f ) {
+        f32 inverse = 1.0f / sqrtf( length );
+        for( u32 i = 0; i < 4; ++i ) {
+            out[i] *= inverse;
+        }
+    }
+}
+static void anim_source_value(
+    ModelAnimation anim, u32 frame, u32 bone, enum AnimChannel channel, f32* out
+) {
+    Transform transform = anim.framePoses[frame][bone];
+    switch( channel ) {
+        case ANIM_CHANNEL_ROTATION: {
+            memcpy( out, &transform.rotation, sizeof(f32) * 4 );
+        } break;
+        case ANIM_CHANNEL_TRANSLATION: {
+            memcpy( out, &transform.translation, sizeof(f32) * 3 );
+            out[3] = 0.0f;
+        } break;
+        case ANIM_CHANNEL_SCALE:
+        default: {
+            memcpy( out, &transform.scale, sizeof(f32) * 3 );
+            out[3] = 0.0f;
+        } break;
+    }
+}
+static f32 anim_value_error( enum AnimChannel channel, const f32* a, const f32* b ) {
+    f32 sign = 1.0f;
+    if( channel == ANIM_CHANNEL_ROTATION ) {
+        f32 dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+        sign = dot < 0.0f ? -1.0f : 1.0f;
+    }
+    f32 result = 0.0f;
+    for( u32 i = 0; i < 4; ++i ) {
+        f32 error = absf( a[i] - b[i] * sign );
+        if( error > result ) {
+            result = error;
+        }
+    }
+    return result;
+}
+/// Largest error of frames [start, end] when only start and end are keys.
+static f32 anim_segment_error(
+    const struct AnimClip* clip, ModelAnimation anim, u32 bone,
+    enum AnimChannel channel, const u16* quantized, u32 start, u32 end
+) {
+    f32 a[4], b[4];
+    anim_key_decode( clip, channel, quantized + start * 3, a );
+    anim_key_decode( clip, channel, quantized + end * 3, b );
+
+    f32 result = 0.0f;
+    for( u32 frame = start; frame <= end; ++frame ) {
+        f32 value[4], source[4];
+        anim_key_lerp(
+            channel, a, b, (f32)( frame - start ) / (f32)( end - start ), value );
+        anim_source_value( anim, frame, bone, channel, source );
+
+        f32 error = anim_value_error( channel, value, source );
+        if( error > result ) {
+            result = error;
+        }
+    }
+    return result;
+}
+
+b32 anim_clip_compress( ModelAnimation anim, struct AnimClip* out_clip ) {
+    memset( out_clip, 0, sizeof(*out_clip) );
+    if( anim.frameCount <= 0 || anim.boneCount <= 0 || anim.frameCount > U16_MAX ) {
+        return false;
+    }
+    u32 frame_count = (u32)anim.frameCount;
+    u32 bone_count  = (u32)anim.boneCount;
+    out_clip->frame_count = frame_count;
+    out_clip->bone_count  = bone_count;
+
+    Transform first = anim.framePoses[0][0];
+    Vector3 translation_min = first.translation, translation_max = first.translation;
+    Vector3 scale_min       = first.scale,       scale_max       = first.scale;
+    for( u32 frame = 0; frame < frame_count; ++frame ) {
+        for( u32 bone = 0; bone < bone_count; ++bone ) {
+            Transform transform = anim.framePoses[frame][bone];
+            translation_min = Vector3Min( translation_min, transform.translation );
+            translation_max = Vector3Max( translation_max, transform.translation );
+            scale_min       = Vector3Min( scale_min, transform.scale );
+            scale_max       = Vector3Max( scale_max, transform.scale );
+        }
+    }
+    out_clip->translation_min  = translation_min;
+    out_clip->translation_step = Vector3Scale(
+        Vector3Subtract( translation_max, translation_min ), 1.0f / (f32)U16_MAX );
+    out_clip->scale_min  = scale_min;
+    out_clip->scale_step = Vector3Scale(
+        Vector3Subtract( scale_max, scale_min ), 1.0f / (f32)U16_MAX );
+
+    const f32 tolerance[ANIM_CHANNEL_COUNT] = {
+        ANIM_ROTATION_TOLERANCE, ANIM_TRANSLATION_TOLERANCE, ANIM_SCALE_TOLERANCE };
+
+    // NOTE(alicia): worst case keeps every frame, shrunk at the end.
+    u32 track_count  = bone_count * ANIM_CHANNEL_COUNT;
+    u32 key_capacity = track_count * frame_count;
+    out_clip->tracks     = MemAlloc( sizeof(struct AnimTrack) * track_count );
+    out_clip->key_frames = MemAlloc( sizeof(u16) * key_capacity );
+    out_clip->key_values = MemAlloc( sizeof(u16) * 3 * key_capacity );
+    u16* quantized       = MemAlloc( sizeof(u16) * 3 * frame_count );
+
+    for( u32 bone = 0; bone < bone_count; ++bone ) {
+        for( u32 channel = 0; channel < ANIM_CHANNEL_COUNT; ++channel ) {
+            for( u32 frame = 0; frame < frame_count; ++frame ) {
+                Transform transform = anim.framePoses[frame][bone];
+                u16* out = quantized + frame * 3;
+                switch( (enum AnimChannel)channel ) {
+                    case ANIM_CHANNEL_ROTATION: {
+                        anim_rotation_encode(
+                            QuaternionNormalize( transform.rotation ), out );
+                    } break;
+                    case ANIM_CHANNEL_TRANSLATION: {
+                        anim_vector_encode( transform.translation,
+                            out_clip->translation_min, out_clip->translation_step, out );
+                    } break;
+                    case ANIM_CHANNEL_SCALE:
+                    case ANIM_CHANNEL_COUNT: {
+                        anim_vector_encode( transform.scale,
+                            out_clip->scale_min, out_clip->scale_step, out );
+                    } break;
+                }
+            }
+
+            struct AnimTrack* track =
+                out_clip->tracks + bone * ANIM_CHANNEL_COUNT + channel;
+            track->first = out_clip->key_count;
+
+            // NOTE(alicia): greedily stretch each segment until
+            // interpolating across it misses a source frame.
+            u32 start = 0;
+            for( ;; ) {
+                u32 key = out_clip->key_count++;
+                out_clip->key_frames[key] = (u16)start;
+                memcpy( out_clip->key_values + key * 3,
+                    quantized + start * 3, sizeof(u16) * 3 );
+                if( start + 1 >= frame_count ) {
+                    break;
+                }
+
+                u32 end = start + 1;
+                for( u32 candidate = start + 2; candidate < frame_count; ++candidate ) {
+                    if( anim_segment_error(
+                        out_clip, anim, bone, channel, quantized, start, candidate
+                    ) > tolerance[channel] ) {
+                        break;
+                    }
+                    end = candidate;
+                }
+
+                f32 error = anim_segment_error(
+                    out_clip, anim, bone, channel, quantized, start, end );
+                if( error > out_clip->max_error[channel] ) {
+                    out_clip->max_error[channel] = error;
+                }
+                start = end;
+            }
+            track->count = out_clip->key_count - track->first;
+        }
+    }
+    MemFree( quantized );
+
+    out_clip->key_frames = MemRealloc(
+        out_clip->key_frames, sizeof(u16) * out_clip->key_count );
+    out_clip->key_values = MemRealloc(
+        out_clip->key_values, sizeof(u16) * 3 * out_clip->key_count );
+    return true;
+}
+void anim_clip_destroy( struct AnimClip* clip ) {
+    MemFree( clip->tracks );
+    MemFree( clip->key_frames );
+    MemFree( clip->key_values );
+    memset( clip, 0, sizeof(*clip) );
+}
+usize anim_clip_memory( const struct AnimClip* clip ) {
+    return
+        sizeof(struct AnimTrack) * clip->bone_count * ANIM_CHANNEL_COUNT +
+        sizeof(u16) * 4 * clip->key_count;
+}
+usize anim_raw_memory( ModelAnimation anim ) {
+    return
+        ( sizeof(Transform) * anim.boneCount + sizeof(Transform*) ) * anim.frameCount +
+        sizeof(BoneInfo) * anim.boneCount;
+}
+f32 anim_clip_duration( const struct AnimClip* clip ) {
+    return (f32)clip->frame_count / ANIM_FRAME_RATE;
+}
+static void anim_track_sample(
+    const struct AnimClip* clip, enum AnimChannel channel,
+    struct AnimTrack track, f32 frame, f32* out
+) {
+    const u16* frames = clip->key_frames + track.first;
+
+    // NOTE(alicia): last key at or before frame.
+    u32 low  = 0;
+    u32 high = track.count - 1;
+    while( low < high ) {
+        u32 mid = ( low + high + 1 ) / 2;
+        if( (f32)frames[mid] <= frame ) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    u32 a = low;
+    u32 b = a + 1;
+    f32 a_frame = frames[a];
+    f32 b_frame;
+    if( b < track.count ) {
+        b_frame = frames[b];
+    } else {
+        // NOTE(alicia): clips loop, last key blends into first.
+        b       = 0;
+        b_frame = (f32)clip->frame_count;
+    }
+
+    f32 a_value[4], b_value[4];
+    anim_key_decode(
+        clip, channel, clip->key_values + ( track.first + a ) * 3, a_value );
+    anim_key_decode(
+        clip, channel, clip->key_values + ( track.first + b ) * 3, b_value );
+
+    f32 t = b_frame > a_frame ? ( frame - a_frame ) / ( b_frame - a_frame ) : 0.0f;
+    anim_key_lerp( channel, a_value, b_value, t, out );
+}
+void anim_clip_sample( const struct AnimClip* clip, f32 time, Transform* out_pose ) {
+    f32 frame = fmodf( time * ANIM_FRAME_RATE, (f32)clip->frame_count );
+    if( frame < 0.0f ) {
+        frame += (f32)clip->frame_count;
+    }
+
+    for( u32 bone = 0; bone < clip->bone_count; ++bone ) {
+        const struct AnimTrack* tracks = clip->tracks + bone * ANIM_CHANNEL_COUNT;
+        f32 value[4];
+
+        anim_track_sample(
+            clip, ANIM_CHANNEL_ROTATION, tracks[ANIM_CHANNEL_ROTATION], frame, value );
+        memcpy( &out_pose[bone].rotation, value, sizeof(f32) * 4 );
+
+        anim_track_sample(
+            clip, ANIM_CHANNEL_TRANSLATION, tracks[ANIM_CHANNEL_TRANSLATION], frame, value );
+        memcpy( &out_pose[bone].translation, value, sizeof(f32) * 3 );
+
+        anim_track_sample(
+            clip, ANIM_CHANNEL_SCALE, tracks[ANIM_CHANNEL_SCALE], frame, value );
+        memcpy( &out_pose[bone].scale, value, sizeof(f32) * 3 );
+    }
+}
+
+b32 anim_sampler_create( u32 bone_count, struct AnimSampler* out_sampler ) {
+    memset( out_sampler, 0, sizeof(*out_sampler) );
+    out_sampler->clip          = -1;
+    out_sampler->previous_clip = -1;
+    if( !bone_count ) {
+        return false;
+    }
+
+    out_sampler->bone_count = bone_count;
+    out_sampler->pose       = MemAlloc( sizeof(Transform) * bone_count );
+    out_sampler->scratch    = MemAlloc( sizeof(Transform) * bone_count );
+    return true;
+}
+void anim_sampler_destroy( struct AnimSampler* sampler ) {
+    MemFree( sampler->pose );
+    MemFree( sampler->scratch );
+    memset( sampler, 0, sizeof(*sampler) );
+    sampler->clip          = -1;
+    sampler->previous_clip = -1;
+}
+
+static b32 anim_clip_usable(
+    const struct AnimSampler* sampler, const struct AnimClip* clip
+) {
+    return clip->frame_count > 0 && clip->bone_count == sampler->bone_count;
+}
+void anim_sampler_play(
+    struct AnimSampler* sampler, const struct AnimClip* clips,
+    int clip, f32 fade_duration
+) {
+    if( clip == sampler->clip ) {
+        return;
+    }
+
+    if( sampler->clip < 0 ) {
+        sampler->clip          = clip;
+        sampler->time          = 0.0f;
+        sampler->previous_clip = -1;
+        return;
+    }
+
+    f32 phase    = 0.0f;
+    f32 duration = anim_clip_duration( clips + sampler->clip );
+    if( duration > 0.0f ) {
+        phase = sampler->time / duration;
+    }
+
+    sampler->previous_clip = sampler->clip;
+    sampler->previous_time = sampler->time;
+    sampler->clip          = clip;
+    sampler->time          = phase * anim_clip_duration( clips + clip );
+    sampler->fade          = 0.0f;
+    sampler->fade_duration = fade_duration;
+}
+void anim_sampler_update(
+    struct AnimSampler* sampler, const struct AnimClip* clips, f32 dt
+) {
+    if( sampler->clip < 0 || !anim_clip_usable( sampler, clips + sampler->clip ) ) {
+        return;
+    }
+    const struct AnimClip* clip = clips + sampler->clip;
+
+    sampler->time = fmodf( sampler->time + dt, anim_clip_duration( clip ) );
+    anim_clip_sample( clip, sampler->time, sampler->pose );
+
+    if( sampler->previous_clip < 0 ) {
+        return;
+    }
+    sampler->fade += dt;
+    const struct AnimClip* previous = clips + sampler->previous_clip;
+    if(
+        sampler->fade >= sampler->fade_duration ||
+        !anim_clip_usable( sampler, previous )
+    ) {
+        sampler->previous_clip = -1;
+        return;
+    }
+
+    sampler->previous_time =
+        fmodf( sampler->previous_time + dt, anim_clip_duration( previous ) );
+    anim_clip_sample( previous, sampler->previous_time, sampler->scratch );
+    anim_pose_blend(
+        sampler->pose, sampler->scratch, sampler->pose,
+        sampler->fade / sampler->fade_duration, sampler->bone_count );
+}
+int anim_sampler_frame(
+    const struct AnimSampler* sampler, const struct AnimClip* clips
+) {
+    if( sampler->clip < 0 || !clips[sampler->clip].frame_count ) {
+        return 0;
+    }
+    int frame = (int)( sampler->time * ANIM_FRAME_RATE + 0.5f );
+    return frame % (int)clips[sampler->clip].frame_count;
+}
+
+void anim_pose_blend(
+    Transform* out_pose, const Transform* a, const Transform* b, f32 t, u32 bone_count
+) {
+#if defined(ANIM_SSE)
+    __m128 t4        = _mm_set1_ps( t );
+    __m128 sign_mask = _mm_set1_ps( -0.0f );
+#endif
+    for( u32 i = 0; i < bone_count; ++i ) {
+        Vector3 translation = Vector3Lerp( a[i].translation, b[i].translation, t );
+        Vector3 scale       = Vector3Lerp( a[i].scale, b[i].scale, t );
+
+#if defined(ANIM_SSE)
+        __m128 qa = _mm_loadu_ps( &a[i].rotation.x );
+        __m128 qb = _mm_loadu_ps( &b[i].rotation.x );
+
+        // NOTE(alicia): dot product broadcast to every lane,
+        // negative dot flips qb onto qa's hemisphere.
+        __m128 dot = _mm_mul_ps( qa, qb );
+        dot = _mm_add_ps( dot, _mm_shuffle_ps( dot, dot, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+        dot = _mm_add_ps( dot, _mm_shuffle_ps( dot, dot, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+        qb  = _mm_xor_ps( qb, _mm_and_ps( dot, sign_mask ) );
+
+        __m128 q = _mm_add_ps( qa, _mm_mul_ps( _mm_sub_ps( qb, qa ), t4 ) );
+        __m128 length = _mm_mul_ps( q, q );
+        length = _mm_add_ps(
+            length, _mm_shuffle_ps( length, length, _MM_SHUFFLE( 2, 3, 0, 1 ) ) );
+        length = _mm_add_ps(
+            length, _mm_shuffle_ps( length, length, _MM_SHUFFLE( 1, 0, 3, 2 ) ) );
+        q = _mm_div_ps( q, _mm_sqrt_ps( length ) );
+
+        Quaternion rotation;
+        _mm_storeu_ps( &rotation.x, q );
+#else
+        Quaternion qa = a[i].rotation;
+        Quaternion qb = b[i].rotation;
+        if( qa.x * qb.x + qa.y * qb.y + qa.z * qb.z + qa.w * qb.w < 0.0f ) {
+            qb = (Quaternion){ -qb.x, -qb.y, -qb.z, -qb.w };
+        }
+        Quaternion rotation = QuaternionNlerp( qa, qb, t );
+#endif
+
+        out_pose[i].translation = translation;
+        out_pose[i].rotation    = rotation;
+        out_pose[i].scale       = scale;
+    }
+}
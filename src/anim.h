@@ -0,0 +1,104 @@
+#if !defined(ANIM_H)
+#define ANIM_H
+/**
+ * @file   anim.h
+ * @brief  Animation sampling.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 19, 2026
+*/
+#include "common.h"
+#include "raylib.h"
+
+/// Clips are stored one pose per frame at this rate.
+#define ANIM_FRAME_RATE (60.0f)
+/// Seconds crossfades between clips take.
+#define ANIM_CROSSFADE_TIME (0.15f)
+
+/// Keys are dropped while interpolating their neighbours stays this close.
+#define ANIM_ROTATION_TOLERANCE    (0.001f)
+#define ANIM_TRANSLATION_TOLERANCE (0.0005f)
+#define ANIM_SCALE_TOLERANCE       (0.001f)
+
+enum AnimChannel {
+    ANIM_CHANNEL_ROTATION,
+    ANIM_CHANNEL_TRANSLATION,
+    ANIM_CHANNEL_SCALE,
+
+    ANIM_CHANNEL_COUNT
+};
+
+/// Keys of one channel of one bone.
+struct AnimTrack {
+    u32 first;
+    u32 count;
+};
+
+/// Compressed looping clip. Every key is three u16s,
+/// rotations are smallest-three and translation and scale
+/// are quantized to clip bounds. First and last frame are always keys.
+struct AnimClip {
+    u32 bone_count;
+    u32 frame_count;
+
+    /// ANIM_CHANNEL_COUNT tracks per bone.
+    struct AnimTrack* tracks;
+    u16* key_frames;
+    u16* key_values;
+    u32  key_count;
+
+    Vector3 translation_min;
+    Vector3 translation_step;
+    Vector3 scale_min;
+    Vector3 scale_step;
+
+    /// Largest difference from source poses, in each channel's units.
+    f32 max_error[ANIM_CHANNEL_COUNT];
+};
+
+/// Samples looping clips at continuous time and crossfades between them.
+struct AnimSampler {
+    u32 bone_count;
+    /// Blended pose, valid after anim_sampler_update.
+    Transform* pose;
+    Transform* scratch;
+
+    int clip;
+    f32 time;
+
+    int previous_clip;
+    f32 previous_time;
+    /// Seconds into crossfade, crossfade is done once past fade_duration.
+    f32 fade;
+    f32 fade_duration;
+};
+
+/// Returns false if anim has no frames or too many to index with u16.
+b32   anim_clip_compress( ModelAnimation anim, struct AnimClip* out_clip );
+void  anim_clip_destroy( struct AnimClip* clip );
+usize anim_clip_memory( const struct AnimClip* clip );
+/// Memory raylib uses for same animation.
+usize anim_raw_memory( ModelAnimation anim );
+f32   anim_clip_duration( const struct AnimClip* clip );
+/// Decompress keys around time and interpolate, wraps around end of clip.
+void  anim_clip_sample( const struct AnimClip* clip, f32 time, Transform* out_pose );
+
+b32  anim_sampler_create( u32 bone_count, struct AnimSampler* out_sampler );
+void anim_sampler_destroy( struct AnimSampler* sampler );
+/// Crossfade into clip over fade_duration seconds.
+/// Playback phase carries over so walk and run cycles stay in step.
+/// Does nothing if clip is already playing.
+void anim_sampler_play(
+    struct AnimSampler* sampler, const struct AnimClip* clips,
+    int clip, f32 fade_duration );
+/// Advance clips by dt and write blended pose.
+void anim_sampler_update(
+    struct AnimSampler* sampler, const struct AnimClip* clips, f32 dt );
+/// Nearest whole frame of current clip.
+int  anim_sampler_frame( const struct AnimSampler* sampler, const struct AnimClip* clips );
+
+/// Lerp translation and scale, nlerp rotation along shortest arc.
+/// Out may alias a or b.
+void anim_pose_blend(
+    Transform* out_pose, const Transform* a, const Transform* b, f32 t, u32 bone_count );
+
+#endif /* header guard */
@@ -34,6 +34,9 @@ typedef u32   b32;
 typedef u64   b64;
 typedef usize bsize;
 
+#define U16_MAX (0xFFFF)
+#define U32_MAX (0xFFFFFFFF)
+
 #if !defined(NULL)
     #define NULL ((void*)0)
 #endif
@@ -13,6 +13,9 @@
 #include "sc_title.h"
 #include "sc_main.h"
 #include "sc_game.h"
+#include "replay.h"
+#include "mathex.h"
+#include "job.h"
 
 #define DEBUG_START SC_MAIN
 #define DEBUG_MUTE
@@ -30,16 +33,43 @@ struct GameState {
 
     Font font_title;
     Font font_text;
+
+    b32 deterministic;
+    f32 tick_accumulator;
+    u32 tick;
+    // NOTE(alicia): input polled every frame, consumed by next tick.
+    struct Input pending_input;
+
+    struct Replay replay;
+    b32 recording;
+    b32 replaying;
+    b32 replay_diverged;
+
+    // NOTE(alicia): game scene ticks on a job while main thread
+    // draws snapshot of previous update, joined at start of next one.
+    struct JobCounter sim_counter;
+    b32 sim_running;
+    f32 sim_dt;
+    struct Input sim_input;
+    u32 sim_events;
+    b32 sim_quit;
 };
 static struct GameState* global_game_state = NULL;
+static struct GameOptions global_game_options = {0};
 
 void game_init(void);
 void internal_scene_load( enum Scene scene );
+void internal_game_fixed_input(void);
+u32  internal_game_fixed_ticks( f32 dt );
+void internal_game_launch( f32 dt );
+void internal_game_join(void);
+void internal_recording_save(void);
 
 void game_update( f32 dt ) {
     if( !global_game_state ) {
         game_init();
     }
+    internal_game_join();
     if( global_game_state->next_scene ) {
         internal_scene_load( global_game_state->next_scene );
     }
@@ -52,7 +82,14 @@ void game_update( f32 dt ) {
             scene_main_update( dt, &global_game_state->scene_state.main );
         } break;
         case SC_GAME: {
-            scene_game_update( dt, &global_game_state->scene_state.game );
+            if( global_game_state->deterministic ) {
+                internal_game_fixed_input();
+            } else {
+                scene_game_update(
+                    dt, &global_game_state->scene_state.game,
+                    &global_game_state->sim_input );
+            }
+            internal_game_launch( dt );
         } break;
         case SC_NONE: break;
     }
@@ -76,6 +113,173 @@ void game_draw( f32 dt ) {
     global_game_state->frames_elapsed++;
 }
 
+static void internal_game_sim_job( void* params ) {
+    struct GameState* state = params;
+    struct SceneGame* game  = &state->scene_state.game;
+    f32 dt = state->sim_dt;
+
+    physics_stats_reset( &game->physics_stats );
+    if( state->deterministic ) {
+        state->sim_events = internal_game_fixed_ticks( dt );
+    } else {
+        state->sim_events = scene_game_tick( dt, game, &state->sim_input );
+    }
+    game->physics_counters = physics_stats_read( &game->physics_stats );
+
+    scene_game_animate( dt, game );
+    scene_game_draw_snapshot_write( game, scene_game_draw_back( game ) );
+}
+void internal_game_launch( f32 dt ) {
+    struct GameState* state = global_game_state;
+    state->sim_dt      = dt;
+    state->sim_events  = 0;
+    state->sim_running = true;
+    atomic_init( &state->sim_counter.pending, 0 );
+    job_enqueue( internal_game_sim_job, state, &state->sim_counter );
+}
+void internal_game_join(void) {
+    struct GameState* state = global_game_state;
+    if( !state->sim_running ) {
+        return;
+    }
+    job_wait( &state->sim_counter );
+    state->sim_running = false;
+
+    // NOTE(alicia): sounds, music and scene changes stay on main thread.
+    struct SceneGame* game = &state->scene_state.game;
+    game->draw_front ^= 1;
+    scene_game_events( game, state->sim_events );
+    if( state->sim_quit ) {
+        state->sim_quit = false;
+        quit_game();
+    }
+}
+
+void internal_game_fixed_input(void) {
+    struct GameState*  state = global_game_state;
+    struct SceneGame*  game  = &state->scene_state.game;
+
+    struct Input input;
+    scene_game_poll( game, &input );
+
+    // NOTE(alicia): frames and ticks don't line up so edge
+    // triggered input is kept until a tick consumes it.
+    struct Input* pending = &state->pending_input;
+    pending->jump        = pending->jump || input.jump;
+    pending->jump_hold   = input.jump_hold;
+    pending->is_moving   = input.is_moving;
+    pending->run_hold    = input.run_hold;
+    pending->move        = input.move;
+    pending->rotation    = Vector2Add( pending->rotation, input.rotation );
+    pending->resize_hold = input.resize_hold;
+    pending->rewind_hold = input.rewind_hold;
+
+    if( state->replaying ) {
+        u32 target = state->tick;
+        if( IsKeyPressed( KEY_RIGHT ) ) {
+            target += REPLAY_SEEK_TICKS;
+        }
+        if( IsKeyPressed( KEY_LEFT ) ) {
+            target = target > REPLAY_SEEK_TICKS ? target - REPLAY_SEEK_TICKS : 0;
+        }
+        if( IsKeyPressed( KEY_HOME ) ) {
+            target = 0;
+        }
+
+        if( target != state->tick ) {
+            u32 reached = replay_seek( &state->replay, game, target );
+            if( reached != U32_MAX ) {
+                TraceLog( LOG_INFO, "Replay seek to tick %u", reached );
+                state->tick             = reached;
+                state->tick_accumulator = 0.0f;
+                scene_game_draw_snapshot_write( game, scene_game_draw_front( game ) );
+            }
+        }
+    }
+}
+u32 internal_game_fixed_ticks( f32 dt ) {
+    struct GameState*  state   = global_game_state;
+    struct SceneGame*  game    = &state->scene_state.game;
+    struct Input*      pending = &state->pending_input;
+
+    state->tick_accumulator += dt;
+    u32 events = 0;
+    u32 ticks  = 0;
+    while(
+        state->tick_accumulator >= SIM_TICK_DT &&
+        ticks < SIM_MAX_TICKS_PER_FRAME
+    ) {
+        state->tick_accumulator -= SIM_TICK_DT;
+        ticks++;
+
+        struct Input tick_input = *pending;
+        if( state->replaying ) {
+            if( state->tick >= state->replay.frame_count ) {
+                TraceLog( LOG_INFO,
+                    "Replay finished after %u ticks, no divergence.", state->tick );
+                state->replaying = false;
+                state->sim_quit  = true;
+                break;
+            }
+            tick_input = state->replay.frames[state->tick].input;
+        } else {
+            pending->jump     = false;
+            pending->rotation = v2_zero();
+        }
+
+        if( state->recording ) {
+            replay_keyframe( &state->replay, game );
+        }
+
+        float_env_init();
+        events |= scene_game_tick( SIM_TICK_DT, game, &tick_input );
+        u64 hash = scene_game_hash( game );
+
+        if( state->replaying ) {
+            u64 expected = state->replay.frames[state->tick].hash;
+            if( hash != expected ) {
+                TraceLog( LOG_ERROR,
+                    "Replay diverged at tick %u! expected 0x%016llx, got 0x%016llx",
+                    state->tick, (unsigned long long)expected, (unsigned long long)hash );
+                state->replay_diverged = true;
+                state->replaying       = false;
+                state->sim_quit        = true;
+                break;
+            }
+        } else if( state->recording ) {
+            replay_push( &state->replay, &tick_input, hash );
+        }
+
+        state->tick++;
+        if( events & GAME_EVENT_EXIT ) {
+            break;
+        }
+    }
+
+    // NOTE(alicia): drop backlog after a long stall instead
+    // of trying to catch up over the next few frames.
+    if( ticks >= SIM_MAX_TICKS_PER_FRAME ) {
+        state->tick_accumulator = 0.0f;
+    }
+    return events;
+}
+
+void internal_recording_save(void) {
+    struct GameState* state = global_game_state;
+    if( !state->recording ) {
+        return;
+    }
+    state->recording = false;
+
+    const char* path = global_game_options.record_path;
+    if( replay_save( &state->replay, path ) ) {
+        TraceLog( LOG_INFO, "Saved %u ticks to %s", state->replay.frame_count, path );
+    } else {
+        TraceLog( LOG_WARNING, "Failed to write %s!", path );
+    }
+    replay_free( &state->replay );
+}
+
 void internal_scene_load( enum Scene scene ) {
     EnableCursor();
     global_game_state->elapsed        = 0.0f;
@@ -90,6 +294,7 @@ void internal_scene_load( enum Scene scene ) {
             scene_main_unload( &global_game_state->scene_state.main );
         } break;
         case SC_GAME: {
+            internal_recording_save();
             scene_game_unload( &global_game_state->scene_state.game );
         } break;
         case SC_NONE: break;
@@ -104,6 +309,16 @@ void internal_scene_load( enum Scene scene ) {
             scene_main_load( &global_game_state->scene_state.main );
         } break;
         case SC_GAME: {
+            global_game_state->tick_accumulator = 0.0f;
+            global_game_state->tick             = 0;
+            memset(
+                &global_game_state->pending_input, 0,
+                sizeof(global_game_state->pending_input) );
+            // NOTE(alicia): scene state is a union, clear whatever
+            // previous scene left behind so every run starts equal.
+            memset(
+                &global_game_state->scene_state.game, 0,
+                sizeof(global_game_state->scene_state.game) );
             scene_game_load( &global_game_state->scene_state.game );
         } break;
         case SC_NONE: break;
@@ -115,6 +330,19 @@ void scene_load( enum Scene scene ) {
     global_game_state->next_scene = scene;
 }
 
+void game_set_options( const struct GameOptions* options ) {
+    global_game_options = *options;
+}
+void game_shutdown(void) {
+    if( global_game_state ) {
+        internal_game_join();
+        internal_recording_save();
+    }
+}
+b32 game_replay_diverged(void) {
+    return global_game_state && global_game_state->replay_diverged;
+}
+
 void game_init(void) {
     struct GameState* state = MemAlloc( sizeof(*state) );
 
@@ -137,6 +365,34 @@ void game_init(void) {
     }
 
     global_game_state = state;
+    float_env_init();
+
+    state->deterministic =
+        global_game_options.deterministic || global_game_options.replay_path;
+
+    if( global_game_options.replay_path ) {
+        if( !replay_load( global_game_options.replay_path, &state->replay ) ) {
+            TraceLog( LOG_ERROR,
+                "Failed to load replay %s!", global_game_options.replay_path );
+            state->replay_diverged = true;
+            quit_game();
+        } else if( state->replay.tick_dt != SIM_TICK_DT ) {
+            TraceLog( LOG_ERROR, "Replay %s was recorded at a different tick rate!",
+                global_game_options.replay_path );
+            state->replay_diverged = true;
+            quit_game();
+        } else {
+            state->replaying = true;
+        }
+    } else if( global_game_options.record_path ) {
+        replay_begin( &state->replay, 0, SIM_TICK_DT );
+        state->recording = true;
+    }
+
+    if( state->replaying || state->recording ) {
+        internal_scene_load( SC_GAME );
+        return;
+    }
 
 #if defined(DEBUG)
     internal_scene_load( DEBUG_START );
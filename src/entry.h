@@ -27,6 +27,22 @@ static inline const char* scene_to_string( enum Scene scene ) {
 
 void scene_load( enum Scene scene );
 
+struct GameOptions {
+    /// Run game scene at fixed SIM_TICK_DT instead of frame time.
+    b32 deterministic;
+    /// Record game scene input and state hashes to this path.
+    const char* record_path;
+    /// Play back recorded input and verify state hashes.
+    /// Implies deterministic.
+    const char* replay_path;
+};
+/// Must be called before first game_update.
+void game_set_options( const struct GameOptions* options );
+/// Flush recording if game quits while game scene is running.
+void game_shutdown(void);
+/// True if replay state hash did not match recording.
+b32  game_replay_diverged(void);
+
 void game_update( f32 dt );
 void game_draw( f32 dt );
 
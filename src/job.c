@@ -0,0 +1,427 @@
+/**
+ * @file   job.c
+ * @brief  Game job system.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 18, 2026
+*/
+#include "job.h"
+#include "mathex.h"
+// IWYU pragma: begin_keep
+#include <string.h>
+// IWYU pragma: end_keep
+
+#if defined(PLATFORM_WEB)
+    #define JOB_THREADS_ENABLED 0
+#else
+    #define JOB_THREADS_ENABLED 1
+#endif
+
+#if JOB_THREADS_ENABLED
+
+#if defined(_WIN32)
+// NOTE(alicia): windows.h conflicts with raylib so
+// only the handful of functions used here are declared.
+#define JOB_WINAPI __stdcall
+typedef unsigned long (JOB_WINAPI *JobWin32ThreadProc)( void* );
+__declspec(dllimport) void* JOB_WINAPI CreateThread(
+    void*, usize, JobWin32ThreadProc, void*, unsigned long, unsigned long* );
+__declspec(dllimport) void* JOB_WINAPI CreateSemaphoreA(
+    void*, long, long, const char* );
+__declspec(dllimport) int JOB_WINAPI ReleaseSemaphore( void*, long, long* );
+__declspec(dllimport) unsigned long JOB_WINAPI WaitForSingleObject(
+    void*, unsigned long );
+__declspec(dllimport) int JOB_WINAPI CloseHandle( void* );
+__declspec(dllimport) unsigned long JOB_WINAPI GetActiveProcessorCount( unsigned short );
+__declspec(dllimport) int JOB_WINAPI SwitchToThread(void);
+
+#define JOB_WIN32_INFINITE            (0xFFFFFFFF)
+#define JOB_WIN32_ALL_PROCESSOR_GROUPS (0xFFFF)
+
+typedef void* JobThread;
+typedef void* JobSemaphore;
+#else
+#include <pthread.h>
+#include <semaphore.h>
+#include <sched.h>
+#include <unistd.h>
+
+typedef pthread_t JobThread;
+typedef sem_t     JobSemaphore;
+#endif
+
+#endif /* JOB_THREADS_ENABLED */
+
+struct JobEntry {
+    JobFN*             proc;
+    void*              params;
+    struct JobCounter* counter;
+};
+/// Owner pushes and pops at bottom, thieves take from top.
+struct JobDeque {
+    atomic_flag lock;
+    u32 top;
+    u32 bottom;
+    struct JobEntry entries[JOB_DEQUE_CAPACITY];
+} __attribute__((aligned(64)));
+
+struct JobSystem {
+    u32 thread_count;
+    u32 worker_count;
+    atomic_uint running;
+    atomic_uint sleeping;
+#if JOB_THREADS_ENABLED
+    JobSemaphore wakeup;
+    JobThread    threads[JOB_MAX_THREADS];
+#endif
+    struct JobDeque deques[JOB_MAX_THREADS];
+};
+
+static struct JobSystem global_job_system;
+static _Thread_local u32 global_job_thread_index = 0;
+
+static void job_pause(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+static void job_deque_lock( struct JobDeque* deque ) {
+    while( atomic_flag_test_and_set( &deque->lock ) ) {
+        job_pause();
+    }
+}
+static void job_deque_unlock( struct JobDeque* deque ) {
+    atomic_flag_clear( &deque->lock );
+}
+static b32 job_deque_push( struct JobDeque* deque, struct JobEntry entry ) {
+    job_deque_lock( deque );
+    b32 result = deque->bottom - deque->top < JOB_DEQUE_CAPACITY;
+    if( result ) {
+        deque->entries[deque->bottom & (JOB_DEQUE_CAPACITY - 1)] = entry;
+        deque->bottom++;
+    }
+    job_deque_unlock( deque );
+    return result;
+}
+/// Pops bottom entry only if it counts towards counter.
+static b32 job_deque_pop_counter(
+    struct JobDeque* deque, struct JobCounter* counter, struct JobEntry* out_entry
+) {
+    job_deque_lock( deque );
+    b32 result =
+        deque->bottom != deque->top &&
+        deque->entries[(deque->bottom - 1) & (JOB_DEQUE_CAPACITY - 1)].counter == counter;
+    if( result ) {
+        deque->bottom--;
+        *out_entry = deque->entries[deque->bottom & (JOB_DEQUE_CAPACITY - 1)];
+    }
+    job_deque_unlock( deque );
+    return result;
+}
+
+static void job_run( struct JobEntry* entry ) {
+    entry->proc( entry->params );
+    atomic_fetch_sub( &entry->counter->pending, 1 );
+}
+
+#if JOB_THREADS_ENABLED
+
+static b32 job_deque_pop( struct JobDeque* deque, struct JobEntry* out_entry ) {
+    job_deque_lock( deque );
+    b32 result = deque->bottom != deque->top;
+    if( result ) {
+        deque->bottom--;
+        *out_entry = deque->entries[deque->bottom & (JOB_DEQUE_CAPACITY - 1)];
+    }
+    job_deque_unlock( deque );
+    return result;
+}
+static b32 job_deque_steal( struct JobDeque* deque, struct JobEntry* out_entry ) {
+    job_deque_lock( deque );
+    b32 result = deque->bottom != deque->top;
+    if( result ) {
+        *out_entry = deque->entries[deque->top & (JOB_DEQUE_CAPACITY - 1)];
+        deque->top++;
+    }
+    job_deque_unlock( deque );
+    return result;
+}
+
+/// Run one job from own deque or steal one from another thread.
+static b32 job_run_next(void) {
+    struct JobSystem* system = &global_job_system;
+    u32 self = global_job_thread_index;
+
+    struct JobEntry entry;
+    if( job_deque_pop( system->deques + self, &entry ) ) {
+        job_run( &entry );
+        return true;
+    }
+    for( u32 i = 1; i < system->thread_count; ++i ) {
+        u32 victim = ( self + i ) % system->thread_count;
+        if( job_deque_steal( system->deques + victim, &entry ) ) {
+            job_run( &entry );
+            return true;
+        }
+    }
+    return false;
+}
+
+static u32 job_core_count(void) {
+#if defined(_WIN32)
+    return (u32)GetActiveProcessorCount( JOB_WIN32_ALL_PROCESSOR_GROUPS );
+#else
+    long count = sysconf( _SC_NPROCESSORS_ONLN );
+    return count > 0 ? (u32)count : 1;
+#endif
+}
+static void job_yield(void) {
+#if defined(_WIN32)
+    SwitchToThread();
+#else
+    sched_yield();
+#endif
+}
+static b32 job_semaphore_create( JobSemaphore* out_semaphore ) {
+#if defined(_WIN32)
+    *out_semaphore = CreateSemaphoreA( NULL, 0, 0x7FFFFFFF, NULL );
+    return *out_semaphore != NULL;
+#else
+    return sem_init( out_semaphore, 0, 0 ) == 0;
+#endif
+}
+static void job_semaphore_wait( JobSemaphore* semaphore ) {
+#if defined(_WIN32)
+    WaitForSingleObject( *semaphore, JOB_WIN32_INFINITE );
+#else
+    while( sem_wait( semaphore ) != 0 ) {
+    }
+#endif
+}
+static void job_semaphore_signal( JobSemaphore* semaphore, u32 count ) {
+#if defined(_WIN32)
+    ReleaseSemaphore( *semaphore, (long)count, NULL );
+#else
+    for( u32 i = 0; i < count; ++i ) {
+        sem_post( semaphore );
+    }
+#endif
+}
+static void job_semaphore_destroy( JobSemaphore* semaphore ) {
+#if defined(_WIN32)
+    CloseHandle( *semaphore );
+#else
+    sem_destroy( semaphore );
+#endif
+}
+
+static void job_worker( u32 index ) {
+    struct JobSystem* system = &global_job_system;
+    global_job_thread_index  = index;
+    float_env_init();
+
+    while( atomic_load( &system->running ) ) {
+        if( job_run_next() ) {
+            continue;
+        }
+
+        // NOTE(alicia): announce sleep before checking deques one
+        // more time so job_enqueue never misses a sleeping worker.
+        atomic_fetch_add( &system->sleeping, 1 );
+        if( job_run_next() ) {
+            atomic_fetch_sub( &system->sleeping, 1 );
+            continue;
+        }
+        if( atomic_load( &system->running ) ) {
+            job_semaphore_wait( &system->wakeup );
+        }
+        atomic_fetch_sub( &system->sleeping, 1 );
+    }
+}
+
+#if defined(_WIN32)
+static unsigned long JOB_WINAPI job_thread_proc( void* params ) {
+    job_worker( (u32)(usize)params );
+    return 0;
+}
+#else
+static void* job_thread_proc( void* params ) {
+    job_worker( (u32)(usize)params );
+    return NULL;
+}
+#endif
+
+#endif /* JOB_THREADS_ENABLED */
+
+b32 job_system_init(void) {
+    struct JobSystem* system = &global_job_system;
+    memset( system, 0, sizeof(*system) );
+    for( u32 i = 0; i < JOB_MAX_THREADS; ++i ) {
+        atomic_flag_clear( &system->deques[i].lock );
+    }
+    system->thread_count    = 1;
+    global_job_thread_index = 0;
+
+#if JOB_THREADS_ENABLED
+    u32 thread_count = job_core_count();
+    if( thread_count > JOB_MAX_THREADS ) {
+        thread_count = JOB_MAX_THREADS;
+    }
+    if( thread_count <= 1 ) {
+        TraceLog( LOG_INFO, "Job system: single core, jobs run inline." );
+        return true;
+    }
+
+    if( !job_semaphore_create( &system->wakeup ) ) {
+        TraceLog( LOG_WARNING, "Job system: failed to create semaphore!" );
+        return false;
+    }
+    atomic_store( &system->running, true );
+
+    // NOTE(alicia): thread_count is read by workers while stealing,
+    // it must not change once the first worker is running.
+    // deques of workers that failed to spawn just stay empty.
+    system->thread_count = thread_count;
+    for( u32 i = 1; i < thread_count; ++i ) {
+        b32 created;
+#if defined(_WIN32)
+        system->threads[i] = CreateThread(
+            NULL, 0, job_thread_proc, (void*)(usize)i, 0, NULL );
+        created = system->threads[i] != NULL;
+#else
+        created = pthread_create(
+            system->threads + i, NULL, job_thread_proc, (void*)(usize)i ) == 0;
+#endif
+        if( !created ) {
+            TraceLog( LOG_WARNING, "Job system: failed to create worker %u!", i );
+            break;
+        }
+        system->worker_count++;
+    }
+
+    TraceLog( LOG_INFO, "Job system: %u threads.", system->worker_count + 1 );
+#endif
+    return true;
+}
+void job_system_shutdown(void) {
+#if JOB_THREADS_ENABLED
+    struct JobSystem* system = &global_job_system;
+    if( system->thread_count <= 1 ) {
+        return;
+    }
+
+    atomic_store( &system->running, false );
+    job_semaphore_signal( &system->wakeup, system->worker_count );
+    for( u32 i = 1; i <= system->worker_count; ++i ) {
+#if defined(_WIN32)
+        WaitForSingleObject( system->threads[i], JOB_WIN32_INFINITE );
+        CloseHandle( system->threads[i] );
+#else
+        pthread_join( system->threads[i], NULL );
+#endif
+    }
+    job_semaphore_destroy( &system->wakeup );
+    system->thread_count = 1;
+    system->worker_count = 0;
+#endif
+}
+u32 job_thread_count(void) {
+    return global_job_system.thread_count ? global_job_system.thread_count : 1;
+}
+u32 job_thread_index(void) {
+    return global_job_thread_index;
+}
+
+void job_enqueue( JobFN* job, void* params, struct JobCounter* counter ) {
+    struct JobSystem* system = &global_job_system;
+
+    struct JobEntry entry;
+    entry.proc    = job;
+    entry.params  = params;
+    entry.counter = counter;
+
+    atomic_fetch_add( &counter->pending, 1 );
+    if(
+        system->thread_count <= 1 ||
+        !job_deque_push( system->deques + global_job_thread_index, entry )
+    ) {
+        job_run( &entry );
+        return;
+    }
+
+#if JOB_THREADS_ENABLED
+    if( atomic_load( &system->sleeping ) ) {
+        job_semaphore_signal( &system->wakeup, 1 );
+    }
+#endif
+}
+void job_wait( struct JobCounter* counter ) {
+    struct JobSystem* system = &global_job_system;
+    struct JobDeque*  deque  = system->deques + global_job_thread_index;
+    // NOTE(alicia): only jobs of counter are run while waiting.
+    // any other job could be a whole batch session that would
+    // stall whoever is waiting here and nest without bound.
+    // jobs of counter were pushed to own deque after anything
+    // older so they are always at the bottom.
+    while( atomic_load( &counter->pending ) ) {
+        struct JobEntry entry;
+        if( job_deque_pop_counter( deque, counter, &entry ) ) {
+            job_run( &entry );
+        } else {
+#if JOB_THREADS_ENABLED
+            job_yield();
+#endif
+        }
+    }
+}
+
+struct JobRange {
+    JobRangeFN* fn;
+    void*       params;
+    u32         begin;
+    u32         end;
+};
+static void job_range_proc( void* params ) {
+    struct JobRange* range = params;
+    range->fn( range->params, range->begin, range->end, global_job_thread_index );
+}
+void job_parallel_for( u32 count, u32 batch, JobRangeFN* fn, void* params ) {
+    if( !count ) {
+        return;
+    }
+    if( !batch ) {
+        batch = 1;
+    }
+    if( count <= batch || job_thread_count() <= 1 ) {
+        fn( params, 0, count, global_job_thread_index );
+        return;
+    }
+
+    u32 range_count = ( count + batch - 1 ) / batch;
+    if( range_count > JOB_MAX_RANGES ) {
+        range_count = JOB_MAX_RANGES;
+    }
+    u32 step = ( count + range_count - 1 ) / range_count;
+
+    struct JobRange   ranges[JOB_MAX_RANGES];
+    struct JobCounter counter;
+    atomic_init( &counter.pending, 0 );
+
+    u32 begin = 0;
+    u32 used  = 0;
+    while( begin < count ) {
+        struct JobRange* range = ranges + used++;
+        range->fn     = fn;
+        range->params = params;
+        range->begin  = begin;
+        range->end    = begin + step < count ? begin + step : count;
+        begin         = range->end;
+    }
+
+    // NOTE(alicia): first range runs on calling thread,
+    // the rest are stolen by workers.
+    for( u32 i = 1; i < used; ++i ) {
+        job_enqueue( job_range_proc, ranges + i, &counter );
+    }
+    job_range_proc( ranges + 0 );
+    job_wait( &counter );
+}
@@ -0,0 +1,50 @@
+#if !defined(JOB_H)
+#define JOB_H
+/**
+ * @file   job.h
+ * @brief  Game job system.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 18, 2026
+*/
+#include "common.h"
+#include <stdatomic.h>
+
+/// Maximum number of threads, including main thread.
+#define JOB_MAX_THREADS (16)
+/// Entries per thread deque, must be a power of two.
+#define JOB_DEQUE_CAPACITY (256)
+/// Maximum number of ranges job_parallel_for splits work into.
+#define JOB_MAX_RANGES (64)
+
+/// Function prototype for jobs.
+typedef void JobFN( void* params );
+/// Function prototype for job_parallel_for.
+/// Processes items in [begin, end), thread is job_thread_index() of caller.
+typedef void JobRangeFN( void* params, u32 begin, u32 end, u32 thread );
+
+/// Counts jobs that have not finished yet.
+/// Zero initialize before enqueueing.
+struct JobCounter {
+    atomic_uint pending;
+};
+
+/// Spawn one worker per core, minus main thread.
+/// On web no workers are spawned and jobs run inline.
+b32  job_system_init(void);
+void job_system_shutdown(void);
+/// Number of threads that run jobs, including main thread.
+u32  job_thread_count(void);
+/// Index of calling thread, 0 is main thread.
+u32  job_thread_index(void);
+
+/// Push job onto calling thread's deque, idle workers steal from it.
+/// Runs job inline if deque is full or job system has no workers.
+void job_enqueue( JobFN* job, void* params, struct JobCounter* counter );
+/// Run pending jobs of counter on calling thread until it reaches zero.
+/// Jobs of other counters are left to workers.
+void job_wait( struct JobCounter* counter );
+/// Split [0, count) into ranges of at least batch items and
+/// run them across workers. Returns once every range is done.
+void job_parallel_for( u32 count, u32 batch, JobRangeFN* fn, void* params );
+
+#endif /* header guard */
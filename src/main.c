@@ -7,7 +7,11 @@
 #include "raylib.h"
 #include "entry.h"
 #include "common.h"
+#include "tools.h"
+#include "job.h"
 #include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
 #if defined(PLATFORM_WEB)
     #include <emscripten/emscripten.h>
 #endif
@@ -16,9 +20,45 @@ static b32 should_game_quit = false;
 void Update(void);
 void CustomLog( int msgType, const char* text, va_list args );
 
+enum Tool {
+    TOOL_NONE,
+    TOOL_BENCH,
+    TOOL_BAKE_SDF,
+    TOOL_BATCH,
+    TOOL_FUZZ,
+};
+
 int main( int argc, char** argv ) {
     unused( argc, argv );
 
+    enum Tool tool = TOOL_NONE;
+    u32 seed = BENCH_SEED;
+    struct GameOptions options;
+    memset( &options, 0, sizeof(options) );
+#if !defined(PLATFORM_WEB)
+    for( int i = 1; i < argc; ++i ) {
+        if( strcmp( argv[i], "--bench" ) == 0 ) {
+            tool = TOOL_BENCH;
+        } else if( strcmp( argv[i], "--bake-sdf" ) == 0 ) {
+            tool = TOOL_BAKE_SDF;
+        } else if( strcmp( argv[i], "--batch" ) == 0 ) {
+            tool = TOOL_BATCH;
+        } else if( strcmp( argv[i], "--fuzz" ) == 0 ) {
+            tool = TOOL_FUZZ;
+        } else if( strcmp( argv[i], "--seed" ) == 0 && i + 1 < argc ) {
+            seed = (u32)strtoul( argv[++i], NULL, 0 );
+        } else if( strcmp( argv[i], "--deterministic" ) == 0 ) {
+            options.deterministic = true;
+        } else if( strcmp( argv[i], "--record" ) == 0 && i + 1 < argc ) {
+            options.deterministic = true;
+            options.record_path   = argv[++i];
+        } else if( strcmp( argv[i], "--replay" ) == 0 && i + 1 < argc ) {
+            options.replay_path = argv[++i];
+        }
+    }
+#endif
+    game_set_options( &options );
+
 #if defined(DEBUG)
     SetTraceLogLevel( LOG_ALL );
     #if !defined(PLATFORM_WEB)
@@ -28,8 +68,37 @@ int main( int argc, char** argv ) {
     SetTraceLogLevel( LOG_NONE );
 #endif
 
+    if( tool ) {
+        SetConfigFlags( FLAG_WINDOW_HIDDEN );
+    }
+
     InitWindow( GAME_WIDTH, GAME_HEIGHT, GAME_NAME );
     InitAudioDevice();
+    job_system_init();
+
+    if( tool ) {
+        int result = 0;
+        switch( tool ) {
+            case TOOL_NONE: break;
+            case TOOL_BENCH: {
+                result = tool_bench();
+            } break;
+            case TOOL_BAKE_SDF: {
+                result = tool_bake_sdf();
+            } break;
+            case TOOL_BATCH: {
+                result = tool_batch( options.replay_path );
+            } break;
+            case TOOL_FUZZ: {
+                result = tool_fuzz( seed );
+            } break;
+        }
+
+        job_system_shutdown();
+        CloseAudioDevice();
+        CloseWindow();
+        return result;
+    }
 
 #if !defined(PLATFORM_WEB) && !defined(DEBUG)
     SetExitKey(KEY_NULL);
@@ -49,9 +118,12 @@ int main( int argc, char** argv ) {
     }
 #endif
 
+    game_shutdown();
+    int result = game_replay_diverged() ? 1 : 0;
+    job_system_shutdown();
     CloseAudioDevice();
     CloseWindow();
-    return 0;
+    return result;
 }
 
 void Update(void) {
@@ -5,6 +5,149 @@
  * @date   August 16, 2024
 */
 #include "mathex.h"
+#include "rlgl.h"
+#include <fenv.h>
+#if defined(__x86_64__) || defined(__SSE__)
+    #include <xmmintrin.h>
+#endif
+
+void float_env_init(void) {
+    fesetround( FE_TONEAREST );
+#if defined(__x86_64__) || defined(__SSE__)
+    // NOTE(alicia): default MXCSR, some drivers turn on flush to zero.
+    _mm_setcsr( 0x1F80 );
+#endif
+}
+
+// NOTE(alicia): det_ functions evaluate in f64 with polynomials
+// and range reduction only, which is plenty for f32 results.
+#define DET_PI      (3.14159265358979323846)
+#define DET_HALF_PI (1.57079632679489661923)
+
+static f64 det_sin_kernel( f64 r ) {
+    f64 r2 = r * r;
+    return r + r * r2 * ( -1.0 / 6.0 + r2 * ( 1.0 / 120.0 + r2 * (
+        -1.0 / 5040.0 + r2 * ( 1.0 / 362880.0 + r2 * (
+        -1.0 / 39916800.0 + r2 * ( 1.0 / 6227020800.0 ) ) ) ) ) );
+}
+static f64 det_cos_kernel( f64 r ) {
+    f64 r2 = r * r;
+    return 1.0 + r2 * ( -1.0 / 2.0 + r2 * ( 1.0 / 24.0 + r2 * (
+        -1.0 / 720.0 + r2 * ( 1.0 / 40320.0 + r2 * (
+        -1.0 / 3628800.0 + r2 * ( 1.0 / 479001600.0 ) ) ) ) ) );
+}
+/// reduce x to r in [-pi/4, pi/4], returns quadrant.
+static i32 det_reduce( f64 x, f64* out_r ) {
+    f64 k = floor( x / DET_HALF_PI + 0.5 );
+    // NOTE(alicia): pi/2 split in two so k * hi is exact.
+    *out_r = ( x - k * 1.5707963267341256 ) - k * 6.077100506506192e-11;
+    return (i32)( (i64)k & 3 );
+}
+static f64 det_sin( f64 x ) {
+    f64 r;
+    switch( det_reduce( x, &r ) ) {
+        case 0:  return  det_sin_kernel( r );
+        case 1:  return  det_cos_kernel( r );
+        case 2:  return -det_sin_kernel( r );
+        default: return -det_cos_kernel( r );
+    }
+}
+static f64 det_cos( f64 x ) {
+    f64 r;
+    switch( det_reduce( x, &r ) ) {
+        case 0:  return  det_cos_kernel( r );
+        case 1:  return -det_sin_kernel( r );
+        case 2:  return -det_cos_kernel( r );
+        default: return  det_sin_kernel( r );
+    }
+}
+static f64 det_atan( f64 x ) {
+    b32 negative = x < 0.0;
+    if( negative ) {
+        x = -x;
+    }
+    b32 inverted = x > 1.0;
+    if( inverted ) {
+        x = 1.0 / x;
+    }
+
+    // NOTE(alicia): atan(x) = 2 atan(x / (1 + sqrt(1 + x^2))),
+    // twice brings x under tan(pi/16) where the series converges fast.
+    x = x / ( 1.0 + sqrt( 1.0 + x * x ) );
+    x = x / ( 1.0 + sqrt( 1.0 + x * x ) );
+
+    f64 x2 = x * x;
+    f64 result = x * ( 1.0 + x2 * ( -1.0 / 3.0 + x2 * ( 1.0 / 5.0 + x2 * (
+        -1.0 / 7.0 + x2 * ( 1.0 / 9.0 + x2 * ( -1.0 / 11.0 + x2 * (
+        1.0 / 13.0 + x2 * ( -1.0 / 15.0 ) ) ) ) ) ) ) );
+    result *= 4.0;
+
+    if( inverted ) {
+        result = DET_HALF_PI - result;
+    }
+    return negative ? -result : result;
+}
+static f64 det_atan2( f64 y, f64 x ) {
+    if( x > 0.0 ) {
+        return det_atan( y / x );
+    }
+    if( x < 0.0 ) {
+        return signbit( y ) ?
+            det_atan( y / x ) - DET_PI : det_atan( y / x ) + DET_PI;
+    }
+    if( y > 0.0 ) {
+        return DET_HALF_PI;
+    }
+    if( y < 0.0 ) {
+        return -DET_HALF_PI;
+    }
+    return 0.0;
+}
+
+f32 det_sinf( f32 x ) {
+    if( isnan( x ) || isinf( x ) ) {
+        return NAN;
+    }
+    return (f32)det_sin( x );
+}
+f32 det_cosf( f32 x ) {
+    if( isnan( x ) || isinf( x ) ) {
+        return NAN;
+    }
+    return (f32)det_cos( x );
+}
+f32 det_tanf( f32 x ) {
+    if( isnan( x ) || isinf( x ) ) {
+        return NAN;
+    }
+    return (f32)( det_sin( x ) / det_cos( x ) );
+}
+f32 det_asinf( f32 x ) {
+    if( isnan( x ) || x < -1.0f || x > 1.0f ) {
+        return NAN;
+    }
+    f64 d = x;
+    return (f32)det_atan2( d, sqrt( ( 1.0 - d ) * ( 1.0 + d ) ) );
+}
+f32 det_acosf( f32 x ) {
+    if( isnan( x ) || x < -1.0f || x > 1.0f ) {
+        return NAN;
+    }
+    f64 d = x;
+    return (f32)det_atan2( sqrt( ( 1.0 - d ) * ( 1.0 + d ) ), d );
+}
+f32 det_atanf( f32 x ) {
+    if( isnan( x ) ) {
+        return NAN;
+    }
+    return (f32)det_atan( x );
+}
+f32 det_atan2f( f32 y, f32 x ) {
+    if( isnan( x ) || isnan( y ) ) {
+        return NAN;
+    }
+    return (f32)det_atan2( y, x );
+}
 
 f32 inverse_lerp( f32 a, f32 b, f32 v ) {
     return ( v - a ) / ( b - a );
@@ -17,4 +160,107 @@ Vector3 v3_lerp( Vector3 a, Vector3 b, f32 t ) {
         Lerp( a.z, b.z, t ),
     };
 }
+Vector3 v3_transform_direction( Vector3 direction, Matrix m ) {
+    return (Vector3) {
+        m.m0 * direction.x + m.m4 * direction.y + m.m8  * direction.z,
+        m.m1 * direction.x + m.m5 * direction.y + m.m9  * direction.z,
+        m.m2 * direction.x + m.m6 * direction.y + m.m10 * direction.z,
+    };
+}
+Vector3 v3_transform_normal( Vector3 normal, Matrix inverse ) {
+    // NOTE(alicia): multiply by inverse transpose so that
+    // non-uniform scale does not skew normals.
+    Vector3 result = {
+        inverse.m0 * normal.x + inverse.m1 * normal.y + inverse.m2  * normal.z,
+        inverse.m4 * normal.x + inverse.m5 * normal.y + inverse.m6  * normal.z,
+        inverse.m8 * normal.x + inverse.m9 * normal.y + inverse.m10 * normal.z,
+    };
+    return Vector3Normalize( result );
+}
+
+BoundingBox bounds_transform( BoundingBox bounds, Matrix m ) {
+    Vector3 center  = Vector3Multiply(
+        Vector3Add( bounds.min, bounds.max ), v3_scalar( 0.5f ) );
+    Vector3 extents = Vector3Multiply(
+        Vector3Subtract( bounds.max, bounds.min ), v3_scalar( 0.5f ) );
+
+    Vector3 new_center  = Vector3Transform( center, m );
+    Vector3 new_extents = {
+        absf(m.m0) * extents.x + absf(m.m4) * extents.y + absf(m.m8)  * extents.z,
+        absf(m.m1) * extents.x + absf(m.m5) * extents.y + absf(m.m9)  * extents.z,
+        absf(m.m2) * extents.x + absf(m.m6) * extents.y + absf(m.m10) * extents.z,
+    };
 
+    BoundingBox result;
+    result.min = Vector3Subtract( new_center, new_extents );
+    result.max = Vector3Add( new_center, new_extents );
+    return result;
+}
+BoundingBox bounds_merge( BoundingBox a, BoundingBox b ) {
+    BoundingBox result;
+    result.min = Vector3Min( a.min, b.min );
+    result.max = Vector3Max( a.max, b.max );
+    return result;
+}
+b32 bounds_contains( BoundingBox outer, BoundingBox inner ) {
+    return
+        inner.min.x >= outer.min.x && inner.max.x <= outer.max.x &&
+        inner.min.y >= outer.min.y && inner.max.y <= outer.max.y &&
+        inner.min.z >= outer.min.z && inner.max.z <= outer.max.z;
+}
+
+Matrix camera_view_projection( Camera3D camera, f32 aspect ) {
+    Matrix projection;
+    if( camera.projection == CAMERA_ORTHOGRAPHIC ) {
+        f64 top   = camera.fovy / 2.0;
+        f64 right = top * aspect;
+        projection = MatrixOrtho(
+            -right, right, -top, top,
+            RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR );
+    } else {
+        projection = MatrixPerspective(
+            camera.fovy * DEG2RAD, aspect,
+            RL_CULL_DISTANCE_NEAR, RL_CULL_DISTANCE_FAR );
+    }
+    Matrix view = MatrixLookAt( camera.position, camera.target, camera.up );
+    return MatrixMultiply( view, projection );
+}
+static Vector4 frustum_plane( Vector4 a, Vector4 b, f32 sign ) {
+    return (Vector4){
+        a.x + b.x * sign, a.y + b.y * sign, a.z + b.z * sign, a.w + b.w * sign };
+}
+struct Frustum frustum_from_matrix( Matrix m ) {
+    // NOTE(alicia): planes are sums of clip matrix rows,
+    // raymath stores columns so row i is m[i], m[4+i], m[8+i], m[12+i].
+    Vector4 row_x = { m.m0, m.m4, m.m8,  m.m12 };
+    Vector4 row_y = { m.m1, m.m5, m.m9,  m.m13 };
+    Vector4 row_z = { m.m2, m.m6, m.m10, m.m14 };
+    Vector4 row_w = { m.m3, m.m7, m.m11, m.m15 };
+
+    struct Frustum result;
+    result.planes[0] = frustum_plane( row_w, row_x, 1.0f );
+    result.planes[1] = frustum_plane( row_w, row_x, -1.0f );
+    result.planes[2] = frustum_plane( row_w, row_y, 1.0f );
+    result.planes[3] = frustum_plane( row_w, row_y, -1.0f );
+    result.planes[4] = frustum_plane( row_w, row_z, 1.0f );
+    result.planes[5] = frustum_plane( row_w, row_z, -1.0f );
+    return result;
+}
+b32 frustum_overlaps_bounds( const struct Frustum* frustum, BoundingBox bounds ) {
+    for( u32 i = 0; i < 6; ++i ) {
+        Vector4 plane = frustum->planes[i];
+        // NOTE(alicia): test corner furthest along plane normal,
+        // if even that is behind plane then whole box is.
+        Vector3 corner = {
+            plane.x >= 0.0f ? bounds.max.x : bounds.min.x,
+            plane.y >= 0.0f ? bounds.max.y : bounds.min.y,
+            plane.z >= 0.0f ? bounds.max.z : bounds.min.z,
+        };
+        f32 distance =
+            plane.x * corner.x + plane.y * corner.y + plane.z * corner.z + plane.w;
+        if( distance < 0.0f ) {
+            return false;
+        }
+    }
+    return true;
+}
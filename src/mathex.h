@@ -9,14 +9,63 @@
 #include "common.h"
 // IWYU pragma: begin_exports
 #include <math.h>
+// IWYU pragma: end_exports
+
+/// Deterministic replacements for libm functions used by the simulation.
+/// Only correctly rounded IEEE operations are used so results are
+/// identical across compilers, libm versions and platforms.
+f32 det_sinf( f32 x );
+f32 det_cosf( f32 x );
+f32 det_tanf( f32 x );
+f32 det_asinf( f32 x );
+f32 det_acosf( f32 x );
+f32 det_atanf( f32 x );
+f32 det_atan2f( f32 y, f32 x );
+
+// NOTE(alicia): replacements must be visible before raymath is
+// included so its inline functions pick them up too. raymath is
+// made static inline so calls never resolve to raylib's own copy.
+#define sinf( x )     det_sinf( x )
+#define cosf( x )     det_cosf( x )
+#define tanf( x )     det_tanf( x )
+#define asinf( x )    det_asinf( x )
+#define acosf( x )    det_acosf( x )
+#define atanf( x )    det_atanf( x )
+#define atan2f( y, x ) det_atan2f( y, x )
+
+#if !defined(RAYMATH_STATIC_INLINE)
+    #define RAYMATH_STATIC_INLINE
+#endif
+// IWYU pragma: begin_exports
 #include "raymath.h"
 // IWYU pragma: end_exports
 
+/// Round to nearest, exceptions masked, denormals kept.
+/// Call on every thread that runs simulation code.
+void float_env_init(void);
+
 #define absf( x ) ( ((x) < 0.0f) ? ((x) * -1.0f) : (x) )
 
 f32 inverse_lerp( f32 a, f32 b, f32 v );
 
 Vector3 v3_lerp( Vector3 a, Vector3 b, f32 t );
+Vector3 v3_transform_direction( Vector3 direction, Matrix m );
+Vector3 v3_transform_normal( Vector3 normal, Matrix inverse );
+
+BoundingBox bounds_transform( BoundingBox bounds, Matrix m );
+BoundingBox bounds_merge( BoundingBox a, BoundingBox b );
+/// true if inner is entirely inside outer.
+b32 bounds_contains( BoundingBox outer, BoundingBox inner );
+
+/// Planes point inwards, xyz is normal and w is distance.
+struct Frustum {
+    Vector4 planes[6];
+};
+/// Same view projection BeginMode3D sets up for camera.
+Matrix camera_view_projection( Camera3D camera, f32 aspect );
+struct Frustum frustum_from_matrix( Matrix view_projection );
+/// Conservative, boxes near frustum corners can pass while outside.
+b32 frustum_overlaps_bounds( const struct Frustum* frustum, BoundingBox bounds );
 
 #define v2_scalar( v ) (Vector2){ .x=v, .y=v }
 #define v2( _x, _y ) (Vector2){ .x=_x, .y=_y }
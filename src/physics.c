@@ -6,10 +6,43 @@
 */
 #include "physics.h"
 #include "mathex.h"
+#include "job.h"
 // IWYU pragma: begin_keep
 #include <string.h>
 // IWYU pragma: end_keep
 
+void physics_counter_add(
+    struct PhysicsStats* stats, enum PhysicsCounter counter, u64 amount
+) {
+    if( stats ) {
+        stats->slots[job_thread_index()].counters.values[counter] += amount;
+    }
+}
+void physics_stats_reset( struct PhysicsStats* stats ) {
+    memset( stats, 0, sizeof(*stats) );
+}
+struct PhysicsCounters physics_stats_read( const struct PhysicsStats* stats ) {
+    struct PhysicsCounters result;
+    memset( &result, 0, sizeof(result) );
+    for( u32 i = 0; i < JOB_MAX_THREADS; ++i ) {
+        for( u32 j = 0; j < PHYSICS_COUNTER_COUNT; ++j ) {
+            result.values[j] += stats->slots[i].counters.values[j];
+        }
+    }
+    return result;
+}
+const char* physics_counter_name( enum PhysicsCounter counter ) {
+    switch( counter ) {
+        case PHYSICS_COUNTER_OBJECTS:      return "objects";
+        case PHYSICS_COUNTER_BOUNDS_TESTS: return "bounds tests";
+        case PHYSICS_COUNTER_TRIANGLES:    return "triangles";
+        case PHYSICS_COUNTER_RAYS:         return "rays";
+        case PHYSICS_COUNTER_HITS:         return "hits";
+        case PHYSICS_COUNTER_COUNT:        break;
+    }
+    return "unknown";
+}
+
 Vector3 velocity_apply_drag( Vector3 velocity, f32 drag, f32 dt ) {
     f32 multiplier = 1.0f - drag * dt;
     if( multiplier < 0.0f ) {
@@ -272,9 +305,31 @@ struct CollisionResult collision_capsule_triangle(
 
     return collision_sphere_triangle( center, radius, p0, p1, p2 );
 }
+static void mesh_triangle(
+    Mesh mesh, i32 triangle, Matrix mesh_transform,
+    Vector3* out_p0, Vector3* out_p1, Vector3* out_p2
+) {
+    const Vector3* vertices = (const Vector3*)mesh.vertices;
+    Vector3 p0, p1, p2;
+
+    if( mesh.indices ) {
+        p0 = vertices[mesh.indices[triangle * 3 + 0]];
+        p1 = vertices[mesh.indices[triangle * 3 + 1]];
+        p2 = vertices[mesh.indices[triangle * 3 + 2]];
+    } else {
+        p0 = vertices[triangle * 3 + 0];
+        p1 = vertices[triangle * 3 + 1];
+        p2 = vertices[triangle * 3 + 2];
+    }
+
+    *out_p0 = Vector3Transform( p0, mesh_transform );
+    *out_p1 = Vector3Transform( p1, mesh_transform );
+    *out_p2 = Vector3Transform( p2, mesh_transform );
+}
+
 struct CollisionResult collision_capsule_mesh(
     Vector3 cap_start, Vector3 cap_end, f32 radius,
-    Matrix mesh_transform, Mesh mesh
+    Matrix mesh_transform, Mesh mesh, struct PhysicsStats* stats
 ) {
     BoundingBox cap_bound;
     f32 half_radius = radius / 2.0f;
@@ -288,35 +343,871 @@ struct CollisionResult collision_capsule_mesh(
     struct CollisionResult result;
     memset( &result, 0, sizeof(result) );
 
+    physics_counter_add( stats, PHYSICS_COUNTER_BOUNDS_TESTS, 1 );
     if( !CheckCollisionBoxes( cap_bound, mesh_bound ) ) {
         return result;
     }
 
-    const Vector3* vertices = (const Vector3*)mesh.vertices;
     for( int i = 0; i < mesh.triangleCount; ++i ) {
         Vector3 p0, p1, p2;
+        mesh_triangle( mesh, i, mesh_transform, &p0, &p1, &p2 );
+
+        result = collision_capsule_triangle( cap_start, cap_end, radius, p0, p1, p2 );
+
+        if( result.hit ) {
+            physics_counter_add( stats, PHYSICS_COUNTER_TRIANGLES, i + 1 );
+            physics_counter_add( stats, PHYSICS_COUNTER_HITS, 1 );
+            result.triangle = i;
+            return result;
+        }
+    }
+
+    physics_counter_add( stats, PHYSICS_COUNTER_TRIANGLES, mesh.triangleCount );
+    return result;
+}
+Vector3 collision_mesh_vertex( const struct CollisionMesh* mesh, u32 vertex ) {
+    const u16* q = mesh->positions + vertex * 3;
+    return (Vector3) {
+        mesh->quantize_origin.x + (f32)q[0] * mesh->quantize_scale.x,
+        mesh->quantize_origin.y + (f32)q[1] * mesh->quantize_scale.y,
+        mesh->quantize_origin.z + (f32)q[2] * mesh->quantize_scale.z,
+    };
+}
+void collision_mesh_triangle(
+    const struct CollisionMesh* mesh, u32 triangle,
+    Vector3* out_p0, Vector3* out_p1, Vector3* out_p2
+) {
+    u32 i0, i1, i2;
+    if( mesh->wide_indices ) {
+        const u32* index = (const u32*)mesh->indices + triangle * 3;
+        i0 = index[0];
+        i1 = index[1];
+        i2 = index[2];
+    } else {
+        const u16* index = (const u16*)mesh->indices + triangle * 3;
+        i0 = index[0];
+        i1 = index[1];
+        i2 = index[2];
+    }
+    *out_p0 = collision_mesh_vertex( mesh, i0 );
+    *out_p1 = collision_mesh_vertex( mesh, i1 );
+    *out_p2 = collision_mesh_vertex( mesh, i2 );
+}
+static f32 v3_axis( Vector3 v, u32 axis ) {
+    return ((f32*)&v)[axis];
+}
+static BoundingBox bounds_empty(void) {
+    BoundingBox result;
+    result.min = v3_scalar(  INFINITY );
+    result.max = v3_scalar( -INFINITY );
+    return result;
+}
+static f32 bounds_surface_area( BoundingBox bounds ) {
+    Vector3 d = Vector3Subtract( bounds.max, bounds.min );
+    return 2.0f * ( d.x * d.y + d.y * d.z + d.z * d.x );
+}
 
-        if( mesh.indices ) {
-            p0 = vertices[mesh.indices[i * 3 + 0]];
-            p1 = vertices[mesh.indices[i * 3 + 1]];
-            p2 = vertices[mesh.indices[i * 3 + 2]];
+static void bvh_swap( u32* order, Vector3* centroids, u32 a, u32 b ) {
+    u32 tmp_order = order[a];
+    order[a]      = order[b];
+    order[b]      = tmp_order;
+
+    Vector3 tmp  = centroids[a];
+    centroids[a] = centroids[b];
+    centroids[b] = tmp;
+}
+/// partition [first, first + count) so that element nth
+/// is where it would be if the range was sorted on axis.
+static void bvh_select(
+    u32* order, Vector3* centroids, u32 first, u32 count, u32 nth, u32 axis
+) {
+    u32 lo = first;
+    u32 hi = first + count - 1;
+    while( lo < hi ) {
+        f32 pivot = v3_axis( centroids[(lo + hi) / 2], axis );
+        u32 i = lo;
+        u32 j = hi;
+        while( i <= j ) {
+            while( v3_axis( centroids[i], axis ) < pivot ) {
+                i++;
+            }
+            while( v3_axis( centroids[j], axis ) > pivot ) {
+                j--;
+            }
+            if( i <= j ) {
+                bvh_swap( order, centroids, i, j );
+                i++;
+                if( !j ) {
+                    break;
+                }
+                j--;
+            }
+        }
+        if( nth <= j ) {
+            hi = j;
+        } else if( nth >= i ) {
+            lo = i;
         } else {
-            p0 = vertices[i * 3 + 0];
-            p1 = vertices[i * 3 + 1];
-            p2 = vertices[i * 3 + 2];           
+            break;
         }
+    }
+}
+static BoundingBox bvh_range_bounds(
+    const BoundingBox* bounds, const u32* order, u32 first, u32 count
+) {
+    BoundingBox result = bounds_empty();
+    for( u32 i = first; i < first + count; ++i ) {
+        result = bounds_merge( result, bounds[order[i]] );
+    }
+    return result;
+}
+static void bvh_subdivide(
+    struct BVHNode* nodes, u32* node_count,
+    const BoundingBox* bounds, Vector3* centroids, u32* order,
+    u32 leaf_size, u32 node_index
+) {
+    struct BVHNode* node = nodes + node_index;
+    node->bounds = bvh_range_bounds( bounds, order, node->first, node->count );
 
-        p0 = Vector3Transform( p0, mesh_transform );
-        p1 = Vector3Transform( p1, mesh_transform );
-        p2 = Vector3Transform( p2, mesh_transform );
+    if( node->count <= leaf_size ) {
+        return;
+    }
 
-        result = collision_capsule_triangle( cap_start, cap_end, radius, p0, p1, p2 );
+    BoundingBox centroid_bounds = bounds_empty();
+    for( u32 i = node->first; i < node->first + node->count; ++i ) {
+        centroid_bounds.min = Vector3Min( centroid_bounds.min, centroids[i] );
+        centroid_bounds.max = Vector3Max( centroid_bounds.max, centroids[i] );
+    }
+    Vector3 extent = Vector3Subtract( centroid_bounds.max, centroid_bounds.min );
+    u32 axis = 0;
+    if( extent.y > extent.x ) {
+        axis = 1;
+    }
+    if( extent.z > v3_axis( extent, axis ) ) {
+        axis = 2;
+    }
 
-        if( result.hit ) {
-            return result;
+    u32 first      = node->first;
+    u32 count      = node->count;
+    u32 left_count = count / 2;
+    bvh_select( order, centroids, first, count, first + left_count, axis );
+
+    u32 left = *node_count;
+    *node_count += 2;
+
+    nodes[left].first     = first;
+    nodes[left].count     = left_count;
+    nodes[left + 1].first = first + left_count;
+    nodes[left + 1].count = count - left_count;
+
+    node        = nodes + node_index;
+    node->first = left;
+    node->count = 0;
+
+    bvh_subdivide( nodes, node_count, bounds, centroids, order, leaf_size, left );
+    bvh_subdivide( nodes, node_count, bounds, centroids, order, leaf_size, left + 1 );
+}
+/// order must contain count primitive indices into bounds.
+/// nodes must have room for count * 2 nodes.
+static u32 bvh_build(
+    struct BVHNode* nodes, const BoundingBox* bounds,
+    u32* order, u32 count, u32 leaf_size
+) {
+    Vector3* centroids = MemAlloc( sizeof(Vector3) * count );
+    for( u32 i = 0; i < count; ++i ) {
+        BoundingBox b = bounds[order[i]];
+        centroids[i]  = Vector3Multiply(
+            Vector3Add( b.min, b.max ), v3_scalar( 0.5f ) );
+    }
+
+    u32 node_count  = 1;
+    nodes[0].first  = 0;
+    nodes[0].count  = count;
+    bvh_subdivide(
+        nodes, &node_count, bounds, centroids, order, leaf_size, 0 );
+
+    MemFree( centroids );
+    return node_count;
+}
+
+static u16 quantize_axis( f32 value, f32 origin, f32 inv_scale ) {
+    f32 q = roundf( ( value - origin ) * inv_scale );
+    return (u16)Clamp( q, 0.0f, COLLISION_QUANTIZE_MAX );
+}
+static Vector3 quantize_inv_scale( const struct CollisionMesh* mesh ) {
+    Vector3 scale = mesh->quantize_scale;
+    return v3(
+        scale.x > 0.0f ? 1.0f / scale.x : 0.0f,
+        scale.y > 0.0f ? 1.0f / scale.y : 0.0f,
+        scale.z > 0.0f ? 1.0f / scale.z : 0.0f );
+}
+/// rounds outwards so quantized box always contains box.
+static void quantize_bounds(
+    const struct CollisionMesh* mesh, BoundingBox box, u16* out_min, u16* out_max
+) {
+    Vector3 origin    = mesh->quantize_origin;
+    Vector3 inv_scale = quantize_inv_scale( mesh );
+    out_min[0] = (u16)Clamp(
+        floorf( ( box.min.x - origin.x ) * inv_scale.x ), 0.0f, COLLISION_QUANTIZE_MAX );
+    out_min[1] = (u16)Clamp(
+        floorf( ( box.min.y - origin.y ) * inv_scale.y ), 0.0f, COLLISION_QUANTIZE_MAX );
+    out_min[2] = (u16)Clamp(
+        floorf( ( box.min.z - origin.z ) * inv_scale.z ), 0.0f, COLLISION_QUANTIZE_MAX );
+    out_max[0] = (u16)Clamp(
+        ceilf( ( box.max.x - origin.x ) * inv_scale.x ), 0.0f, COLLISION_QUANTIZE_MAX );
+    out_max[1] = (u16)Clamp(
+        ceilf( ( box.max.y - origin.y ) * inv_scale.y ), 0.0f, COLLISION_QUANTIZE_MAX );
+    out_max[2] = (u16)Clamp(
+        ceilf( ( box.max.z - origin.z ) * inv_scale.z ), 0.0f, COLLISION_QUANTIZE_MAX );
+}
+static BoundingBox collision_node_bounds(
+    const struct CollisionMesh* mesh, const struct CollisionNode* node
+) {
+    Vector3 origin = mesh->quantize_origin;
+    Vector3 scale  = mesh->quantize_scale;
+    BoundingBox result;
+    result.min = Vector3Add( origin, Vector3Multiply(
+        scale, v3( node->min[0], node->min[1], node->min[2] ) ) );
+    result.max = Vector3Add( origin, Vector3Multiply(
+        scale, v3( node->max[0], node->max[1], node->max[2] ) ) );
+    return result;
+}
+static b32 collision_node_overlaps(
+    const struct CollisionNode* node, const u16* min, const u16* max
+) {
+    return
+        node->min[0] <= max[0] && node->max[0] >= min[0] &&
+        node->min[1] <= max[1] && node->max[1] >= min[1] &&
+        node->min[2] <= max[2] && node->max[2] >= min[2];
+}
+static u32 weld_hash( const u16* q ) {
+    u32 h = (u32)q[0] * 73856093u;
+    h ^= (u32)q[1] * 19349663u;
+    h ^= (u32)q[2] * 83492791u;
+    return h;
+}
+
+b32 collision_mesh_create( Mesh mesh, struct CollisionMesh* out_mesh ) {
+    memset( out_mesh, 0, sizeof(*out_mesh) );
+    if( !mesh.vertices || !mesh.triangleCount ) {
+        return false;
+    }
+
+    out_mesh->source_vertex_count   = mesh.vertexCount;
+    out_mesh->source_triangle_count = mesh.triangleCount;
+
+    const Vector3* source = (const Vector3*)mesh.vertices;
+    u32 source_index_count = mesh.triangleCount * 3;
+
+    BoundingBox source_bounds = bounds_empty();
+    for( u32 i = 0; i < source_index_count; ++i ) {
+        Vector3 p = source[ mesh.indices ? mesh.indices[i] : i ];
+        source_bounds.min = Vector3Min( source_bounds.min, p );
+        source_bounds.max = Vector3Max( source_bounds.max, p );
+    }
+    Vector3 extent = Vector3Subtract( source_bounds.max, source_bounds.min );
+    Vector3 inv_scale;
+    inv_scale.x = extent.x > 0.0f ? COLLISION_QUANTIZE_MAX / extent.x : 0.0f;
+    inv_scale.y = extent.y > 0.0f ? COLLISION_QUANTIZE_MAX / extent.y : 0.0f;
+    inv_scale.z = extent.z > 0.0f ? COLLISION_QUANTIZE_MAX / extent.z : 0.0f;
+
+    out_mesh->quantize_origin = source_bounds.min;
+    out_mesh->quantize_scale  = Vector3Scale( extent, 1.0f / COLLISION_QUANTIZE_MAX );
+
+    // NOTE(alicia): glb exports tend to duplicate vertices per face.
+    // vertices that quantize to the same position are welded so
+    // that triangles share an index buffer.
+    u32 table_cap = 1;
+    while( table_cap < source_index_count * 2 ) {
+        table_cap <<= 1;
+    }
+    u32* table = MemAlloc( sizeof(u32) * table_cap );
+    memset( table, 0xFF, sizeof(u32) * table_cap );
+
+    u16* positions = MemAlloc( sizeof(u16) * 3 * source_index_count );
+    u32* indices   = MemAlloc( sizeof(u32) * source_index_count );
+    u32 vertex_count   = 0;
+    u32 triangle_count = 0;
+
+    out_mesh->positions = positions;
+
+    for( u32 i = 0; i < (u32)mesh.triangleCount; ++i ) {
+        u32 triangle[3];
+        for( u32 j = 0; j < 3; ++j ) {
+            Vector3 p = source[ mesh.indices ? mesh.indices[i * 3 + j] : i * 3 + j ];
+            u16 q[3];
+            q[0] = quantize_axis( p.x, source_bounds.min.x, inv_scale.x );
+            q[1] = quantize_axis( p.y, source_bounds.min.y, inv_scale.y );
+            q[2] = quantize_axis( p.z, source_bounds.min.z, inv_scale.z );
+
+            u32 slot = weld_hash( q ) & ( table_cap - 1 );
+            for( ;; ) {
+                if( table[slot] == U32_MAX ) {
+                    memcpy( positions + vertex_count * 3, q, sizeof(q) );
+                    table[slot] = vertex_count++;
+                    break;
+                }
+                if( memcmp( positions + table[slot] * 3, q, sizeof(q) ) == 0 ) {
+                    break;
+                }
+                slot = ( slot + 1 ) & ( table_cap - 1 );
+            }
+            triangle[j] = table[slot];
+        }
+
+        if(
+            triangle[0] == triangle[1] ||
+            triangle[1] == triangle[2] ||
+            triangle[2] == triangle[0]
+        ) {
+            continue;
+        }
+        Vector3 p0 = collision_mesh_vertex( out_mesh, triangle[0] );
+        Vector3 p1 = collision_mesh_vertex( out_mesh, triangle[1] );
+        Vector3 p2 = collision_mesh_vertex( out_mesh, triangle[2] );
+        Vector3 cross = Vector3CrossProduct(
+            Vector3Subtract( p1, p0 ), Vector3Subtract( p2, p0 ) );
+        if( Vector3LengthSqr( cross ) <= COLLISION_DEGENERATE_AREA ) {
+            continue;
+        }
+
+        memcpy( indices + triangle_count * 3, triangle, sizeof(triangle) );
+        triangle_count++;
+    }
+    MemFree( table );
+
+    if( !triangle_count ) {
+        MemFree( positions );
+        MemFree( indices );
+        memset( out_mesh, 0, sizeof(*out_mesh) );
+        return false;
+    }
+
+    out_mesh->indices        = indices;
+    out_mesh->wide_indices   = true;
+    out_mesh->vertex_count   = vertex_count;
+    out_mesh->triangle_count = triangle_count;
+    struct BVHNode* nodes    =
+        MemAlloc( sizeof(struct BVHNode) * triangle_count * 2 );
+
+    u32*         order  = MemAlloc( sizeof(u32) * triangle_count );
+    BoundingBox* bounds = MemAlloc( sizeof(BoundingBox) * triangle_count );
+    for( u32 i = 0; i < triangle_count; ++i ) {
+        Vector3 p0, p1, p2;
+        collision_mesh_triangle( out_mesh, i, &p0, &p1, &p2 );
+        bounds[i].min = Vector3Min( p0, Vector3Min( p1, p2 ) );
+        bounds[i].max = Vector3Max( p0, Vector3Max( p1, p2 ) );
+        order[i] = i;
+    }
+
+    out_mesh->node_count = bvh_build(
+        nodes, bounds, order, triangle_count, COLLISION_BVH_LEAF_SIZE );
+
+    // NOTE(alicia): node bounds go on the same grid as positions,
+    // leaf bounds land exactly on grid points of their vertices.
+    out_mesh->nodes =
+        MemAlloc( sizeof(struct CollisionNode) * out_mesh->node_count );
+    for( u32 i = 0; i < out_mesh->node_count; ++i ) {
+        struct CollisionNode* node = out_mesh->nodes + i;
+        quantize_bounds( out_mesh, nodes[i].bounds, node->min, node->max );
+        node->first = nodes[i].first;
+        node->count = nodes[i].count;
+    }
+    MemFree( nodes );
+
+    // NOTE(alicia): store triangles in leaf order so leaves are
+    // contiguous ranges of triangles, then store vertices in order
+    // of first use so that neighboring triangles share cache lines.
+    u32* remap = MemAlloc( sizeof(u32) * vertex_count );
+    memset( remap, 0xFF, sizeof(u32) * vertex_count );
+
+    b32 wide_indices = vertex_count > 0xFFFF + 1;
+    u16* leaf_positions = MemAlloc( sizeof(u16) * 3 * vertex_count );
+    void* leaf_indices  = MemAlloc(
+        ( wide_indices ? sizeof(u32) : sizeof(u16) ) * triangle_count * 3 );
+
+    u32 next_vertex = 0;
+    for( u32 i = 0; i < triangle_count; ++i ) {
+        for( u32 j = 0; j < 3; ++j ) {
+            u32 index = indices[order[i] * 3 + j];
+            if( remap[index] == U32_MAX ) {
+                memcpy( leaf_positions + next_vertex * 3,
+                    positions + index * 3, sizeof(u16) * 3 );
+                remap[index] = next_vertex++;
+            }
+
+            if( wide_indices ) {
+                ((u32*)leaf_indices)[i * 3 + j] = remap[index];
+            } else {
+                ((u16*)leaf_indices)[i * 3 + j] = (u16)remap[index];
+            }
+        }
+    }
+
+    MemFree( remap );
+    MemFree( positions );
+    MemFree( indices );
+    out_mesh->positions    = leaf_positions;
+    out_mesh->indices      = leaf_indices;
+    out_mesh->wide_indices = wide_indices;
+    out_mesh->vertex_count = next_vertex;
+
+    MemFree( bounds );
+    MemFree( order );
+
+    out_mesh->source_memory =
+        sizeof(Vector3) * (usize)mesh.vertexCount +
+        ( mesh.indices ? sizeof(unsigned short) * source_index_count : 0 );
+    TraceLog( LOG_DEBUG,
+        "Collision mesh: %u -> %u triangles, %u -> %u vertices, "
+        "%.2fKiB -> %.2fKiB (BVH %u nodes)",
+        out_mesh->source_triangle_count, out_mesh->triangle_count,
+        out_mesh->source_vertex_count, out_mesh->vertex_count,
+        out_mesh->source_memory / 1024.0f, collision_mesh_memory( out_mesh ) / 1024.0f,
+        out_mesh->node_count );
+
+    return true;
+}
+void collision_mesh_destroy( struct CollisionMesh* mesh ) {
+    MemFree( mesh->positions );
+    MemFree( mesh->indices );
+    MemFree( mesh->nodes );
+    memset( mesh, 0, sizeof(*mesh) );
+}
+BoundingBox collision_mesh_bounds( const struct CollisionMesh* mesh ) {
+    return collision_node_bounds( mesh, mesh->nodes );
+}
+usize collision_mesh_memory( const struct CollisionMesh* mesh ) {
+    return
+        sizeof(u16) * 3 * (usize)mesh->vertex_count +
+        ( mesh->wide_indices ? sizeof(u32) : sizeof(u16) ) *
+            (usize)mesh->triangle_count * 3 +
+        sizeof(struct CollisionNode) * (usize)mesh->node_count;
+}
+
+#define COLLISION_BVH_STACK_SIZE (64)
+
+u32 collision_mesh_query_box(
+    const struct CollisionMesh* mesh, BoundingBox box, struct PhysicsStats* stats,
+    u32* out_triangles, u32 max_triangles
+) {
+    u32 count        = 0;
+    u32 bounds_tests = 1;
+
+    // NOTE(alicia): quantized box is clamped to the grid so
+    // boxes outside the mesh have to be rejected first.
+    if( !CheckCollisionBoxes( box, collision_mesh_bounds( mesh ) ) ) {
+        physics_counter_add( stats, PHYSICS_COUNTER_BOUNDS_TESTS, bounds_tests );
+        return count;
+    }
+    u16 box_min[3], box_max[3];
+    quantize_bounds( mesh, box, box_min, box_max );
+
+    u32 stack[COLLISION_BVH_STACK_SIZE];
+    u32 stack_count = 0;
+    stack[stack_count++] = 0;
+
+    while( stack_count ) {
+        const struct CollisionNode* node = mesh->nodes + stack[--stack_count];
+        bounds_tests++;
+        if( !collision_node_overlaps( node, box_min, box_max ) ) {
+            continue;
         }
+
+        if( !node->count ) {
+            stack[stack_count++] = node->first + 1;
+            stack[stack_count++] = node->first;
+            continue;
+        }
+
+        for( u32 i = node->first; i < node->first + node->count; ++i ) {
+            if( count >= max_triangles ) {
+                physics_counter_add( stats, PHYSICS_COUNTER_BOUNDS_TESTS, bounds_tests );
+                return count;
+            }
+            out_triangles[count++] = i;
+        }
+    }
+
+    physics_counter_add( stats, PHYSICS_COUNTER_BOUNDS_TESTS, bounds_tests );
+    return count;
+}
+
+struct CollisionResult collision_mesh_capsule(
+    Vector3 cap_start, Vector3 cap_end, f32 radius,
+    const struct CollisionMesh* mesh, Matrix transform, Matrix inverse,
+    struct PhysicsStats* stats
+) {
+    struct CollisionResult result;
+    memset( &result, 0, sizeof(result) );
+
+    // NOTE(alicia): only the capsule bounds are moved into mesh space,
+    // candidate triangles are tested in world space so that
+    // non-uniform scale does not turn the capsule into an ellipsoid.
+    BoundingBox cap_bound;
+    cap_bound.min = Vector3SubtractValue( Vector3Min( cap_start, cap_end ), radius );
+    cap_bound.max = Vector3AddValue( Vector3Max( cap_start, cap_end ), radius );
+    BoundingBox local_bound = bounds_transform( cap_bound, inverse );
+
+    u32 bounds_tests = 1;
+    u32 triangles    = 0;
+
+    if( !CheckCollisionBoxes( local_bound, collision_mesh_bounds( mesh ) ) ) {
+        physics_counter_add( stats, PHYSICS_COUNTER_BOUNDS_TESTS, bounds_tests );
+        return result;
+    }
+    u16 local_min[3], local_max[3];
+    quantize_bounds( mesh, local_bound, local_min, local_max );
+
+    u32 stack[COLLISION_BVH_STACK_SIZE];
+    u32 stack_count = 0;
+    stack[stack_count++] = 0;
+
+    while( stack_count ) {
+        const struct CollisionNode* node = mesh->nodes + stack[--stack_count];
+        bounds_tests++;
+        if( !collision_node_overlaps( node, local_min, local_max ) ) {
+            continue;
+        }
+
+        if( !node->count ) {
+            stack[stack_count++] = node->first + 1;
+            stack[stack_count++] = node->first;
+            continue;
+        }
+
+        for( u32 i = node->first; i < node->first + node->count; ++i ) {
+            Vector3 p0, p1, p2;
+            collision_mesh_triangle( mesh, i, &p0, &p1, &p2 );
+
+            p0 = Vector3Transform( p0, transform );
+            p1 = Vector3Transform( p1, transform );
+            p2 = Vector3Transform( p2, transform );
+
+            triangles++;
+            result = collision_capsule_triangle(
+                cap_start, cap_end, radius, p0, p1, p2 );
+            if( result.hit ) {
+                physics_counter_add( stats, PHYSICS_COUNTER_BOUNDS_TESTS, bounds_tests );
+                physics_counter_add( stats, PHYSICS_COUNTER_TRIANGLES, triangles );
+                physics_counter_add( stats, PHYSICS_COUNTER_HITS, 1 );
+                result.triangle = i;
+                return result;
+            }
+        }
+    }
+
+    physics_counter_add( stats, PHYSICS_COUNTER_BOUNDS_TESTS, bounds_tests );
+    physics_counter_add( stats, PHYSICS_COUNTER_TRIANGLES, triangles );
+    memset( &result, 0, sizeof(result) );
+    return result;
+}
+struct CollisionResult collision_mesh_capsule_triangle(
+    Vector3 cap_start, Vector3 cap_end, f32 radius,
+    const struct CollisionMesh* mesh, Matrix transform, i32 triangle,
+    struct PhysicsStats* stats
+) {
+    struct CollisionResult result;
+    memset( &result, 0, sizeof(result) );
+    if( triangle < 0 || (u32)triangle >= mesh->triangle_count ) {
+        return result;
     }
 
+    Vector3 p0, p1, p2;
+    collision_mesh_triangle( mesh, triangle, &p0, &p1, &p2 );
+    p0 = Vector3Transform( p0, transform );
+    p1 = Vector3Transform( p1, transform );
+    p2 = Vector3Transform( p2, transform );
+
+    result = collision_capsule_triangle( cap_start, cap_end, radius, p0, p1, p2 );
+    result.triangle = triangle;
+
+    physics_counter_add( stats, PHYSICS_COUNTER_TRIANGLES, 1 );
+    if( result.hit ) {
+        physics_counter_add( stats, PHYSICS_COUNTER_HITS, 1 );
+    }
     return result;
 }
 
+static b32 ray_box_distance(
+    Vector3 origin, Vector3 inv_direction, BoundingBox box, f32 max_distance
+) {
+    f32 t0 = ( box.min.x - origin.x ) * inv_direction.x;
+    f32 t1 = ( box.max.x - origin.x ) * inv_direction.x;
+    f32 tmin = fminf( t0, t1 );
+    f32 tmax = fmaxf( t0, t1 );
+
+    t0 = ( box.min.y - origin.y ) * inv_direction.y;
+    t1 = ( box.max.y - origin.y ) * inv_direction.y;
+    tmin = fmaxf( tmin, fminf( t0, t1 ) );
+    tmax = fminf( tmax, fmaxf( t0, t1 ) );
+
+    t0 = ( box.min.z - origin.z ) * inv_direction.z;
+    t1 = ( box.max.z - origin.z ) * inv_direction.z;
+    tmin = fmaxf( tmin, fminf( t0, t1 ) );
+    tmax = fminf( tmax, fmaxf( t0, t1 ) );
+
+    return tmax >= fmaxf( tmin, 0.0f ) && tmin <= max_distance;
+}
+static RayCollision ray_collision_to_world(
+    RayCollision local, Ray ray, Matrix inverse
+) {
+    // NOTE(alicia): local ray direction is not normalized so
+    // local distance is already world distance.
+    local.point  = Vector3Add(
+        ray.position, Vector3Multiply( ray.direction, v3_scalar( local.distance ) ) );
+    local.normal = v3_transform_normal( local.normal, inverse );
+    return local;
+}
+
+RayCollision collision_mesh_ray(
+    Ray ray, f32 max_distance,
+    const struct CollisionMesh* mesh, Matrix inverse,
+    struct PhysicsStats* stats, i32* out_triangle
+) {
+    RayCollision result;
+    memset( &result, 0, sizeof(result) );
+    result.distance = max_distance;
+
+    Ray local;
+    local.position  = Vector3Transform( ray.position, inverse );
+    local.direction = v3_transform_direction( ray.direction, inverse );
+
+    Vector3 inv_direction = Vector3Divide( v3_one(), local.direction );
+
+    u32 bounds_tests = 0;
+    u32 triangles    = 0;
+
+    u32 stack[COLLISION_BVH_STACK_SIZE];
+    u32 stack_count = 0;
+    stack[stack_count++] = 0;
+
+    while( stack_count ) {
+        const struct CollisionNode* node = mesh->nodes + stack[--stack_count];
+        bounds_tests++;
+        if( !ray_box_distance(
+            local.position, inv_direction,
+            collision_node_bounds( mesh, node ), result.distance
+        ) ) {
+            continue;
+        }
+
+        if( !node->count ) {
+            stack[stack_count++] = node->first + 1;
+            stack[stack_count++] = node->first;
+            continue;
+        }
+
+        for( u32 i = node->first; i < node->first + node->count; ++i ) {
+            Vector3 p0, p1, p2;
+            collision_mesh_triangle( mesh, i, &p0, &p1, &p2 );
+
+            triangles++;
+            RayCollision hit = GetRayCollisionTriangle( local, p0, p1, p2 );
+            if( hit.hit && hit.distance <= result.distance ) {
+                result = hit;
+                if( out_triangle ) {
+                    *out_triangle = i;
+                }
+            }
+        }
+    }
+
+    physics_counter_add( stats, PHYSICS_COUNTER_RAYS, 1 );
+    physics_counter_add( stats, PHYSICS_COUNTER_BOUNDS_TESTS, bounds_tests );
+    physics_counter_add( stats, PHYSICS_COUNTER_TRIANGLES, triangles );
+
+    if( !result.hit ) {
+        memset( &result, 0, sizeof(result) );
+        return result;
+    }
+
+    physics_counter_add( stats, PHYSICS_COUNTER_HITS, 1 );
+    return ray_collision_to_world( result, ray, inverse );
+}
+RayCollision collision_mesh_ray_triangle(
+    Ray ray, const struct CollisionMesh* mesh, Matrix inverse, i32 triangle,
+    struct PhysicsStats* stats
+) {
+    RayCollision result;
+    memset( &result, 0, sizeof(result) );
+    if( triangle < 0 || (u32)triangle >= mesh->triangle_count ) {
+        return result;
+    }
+
+    Ray local;
+    local.position  = Vector3Transform( ray.position, inverse );
+    local.direction = v3_transform_direction( ray.direction, inverse );
+
+    Vector3 p0, p1, p2;
+    collision_mesh_triangle( mesh, triangle, &p0, &p1, &p2 );
+
+    physics_counter_add( stats, PHYSICS_COUNTER_RAYS, 1 );
+    physics_counter_add( stats, PHYSICS_COUNTER_TRIANGLES, 1 );
+    result = GetRayCollisionTriangle( local, p0, p1, p2 );
+    if( !result.hit ) {
+        return result;
+    }
+    physics_counter_add( stats, PHYSICS_COUNTER_HITS, 1 );
+    return ray_collision_to_world( result, ray, inverse );
+}
+
+static f32 level_bvh_cost( const struct LevelBVH* bvh ) {
+    f32 cost = 0.0f;
+    for( u32 i = 0; i < bvh->node_count; ++i ) {
+        cost += bounds_surface_area( bvh->nodes[i].bounds );
+    }
+    return cost;
+}
+void level_bvh_create(
+    struct LevelBVH* out_bvh, const BoundingBox* bounds,
+    const b32* enabled, u32 object_count
+) {
+    memset( out_bvh, 0, sizeof(*out_bvh) );
+    out_bvh->object_count = object_count;
+    if( !object_count ) {
+        return;
+    }
+
+    out_bvh->bounds = MemAlloc( sizeof(BoundingBox) * object_count );
+    out_bvh->order  = MemAlloc( sizeof(u32) * object_count );
+    out_bvh->nodes  = MemAlloc( sizeof(struct BVHNode) * object_count * 2 );
+
+    memcpy( out_bvh->bounds, bounds, sizeof(BoundingBox) * object_count );
+    for( u32 i = 0; i < object_count; ++i ) {
+        if( enabled[i] ) {
+            out_bvh->order[out_bvh->order_count++] = i;
+        }
+    }
+
+    level_bvh_rebuild( out_bvh );
+}
+void level_bvh_clone( const struct LevelBVH* source, struct LevelBVH* out_bvh ) {
+    memcpy( out_bvh, source, sizeof(*out_bvh) );
+    if( !source->object_count ) {
+        return;
+    }
+
+    out_bvh->bounds = MemAlloc( sizeof(BoundingBox) * source->object_count );
+    out_bvh->order  = MemAlloc( sizeof(u32) * source->object_count );
+    out_bvh->nodes  = MemAlloc( sizeof(struct BVHNode) * source->object_count * 2 );
+
+    memcpy( out_bvh->bounds, source->bounds, sizeof(BoundingBox) * source->object_count );
+    memcpy( out_bvh->order,  source->order,  sizeof(u32) * source->object_count );
+    memcpy( out_bvh->nodes,  source->nodes,  sizeof(struct BVHNode) * source->node_count );
+}
+void level_bvh_destroy( struct LevelBVH* bvh ) {
+    MemFree( bvh->nodes );
+    MemFree( bvh->order );
+    MemFree( bvh->bounds );
+    memset( bvh, 0, sizeof(*bvh) );
+}
+void level_bvh_rebuild( struct LevelBVH* bvh ) {
+    if( !bvh->order_count ) {
+        bvh->node_count = 0;
+        return;
+    }
+
+    bvh->node_count = bvh_build(
+        bvh->nodes, bvh->bounds, bvh->order,
+        bvh->order_count, LEVEL_BVH_LEAF_SIZE );
+
+    bvh->build_cost = level_bvh_cost( bvh );
+    bvh->cost       = bvh->build_cost;
+    bvh->rebuild_count++;
+}
+void level_bvh_set_bounds( struct LevelBVH* bvh, u32 object, BoundingBox bounds ) {
+    bvh->bounds[object] = bounds;
+}
+void level_bvh_refit( struct LevelBVH* bvh ) {
+    // NOTE(alicia): children are always allocated after their parent
+    // so walking the nodes backwards visits children first.
+    for( u32 i = bvh->node_count; i-- > 0; ) {
+        struct BVHNode* node = bvh->nodes + i;
+        if( node->count ) {
+            node->bounds = bvh_range_bounds(
+                bvh->bounds, bvh->order, node->first, node->count );
+        } else {
+            node->bounds = bounds_merge(
+                bvh->nodes[node->first].bounds, bvh->nodes[node->first + 1].bounds );
+        }
+    }
+    bvh->refit_count++;
+
+    bvh->cost = level_bvh_cost( bvh );
+    if( bvh->cost > bvh->build_cost * LEVEL_BVH_REBUILD_RATIO ) {
+        level_bvh_rebuild( bvh );
+    }
+}
+
+void level_bvh_query(
+    const struct LevelBVH* bvh, BoundingBox box,
+    struct PhysicsStats* stats, struct LevelBVHQuery* out_query
+) {
+    out_query->bvh         = bvh;
+    out_query->box         = box;
+    out_query->stats       = stats;
+    out_query->stack_count = 0;
+    out_query->leaf_at     = 0;
+    out_query->leaf_end    = 0;
+    if( bvh->node_count ) {
+        out_query->stack[out_query->stack_count++] = 0;
+    }
+}
+b32 level_bvh_query_next( struct LevelBVHQuery* query, u32* out_object ) {
+    const struct LevelBVH* bvh   = query->bvh;
+    struct PhysicsStats*   stats = query->stats;
+    u32 bounds_tests = 0;
+    for( ;; ) {
+        while( query->leaf_at < query->leaf_end ) {
+            u32 object = bvh->order[query->leaf_at++];
+            bounds_tests++;
+            if( CheckCollisionBoxes( query->box, bvh->bounds[object] ) ) {
+                physics_counter_add( stats, PHYSICS_COUNTER_BOUNDS_TESTS, bounds_tests );
+                *out_object = object;
+                return true;
+            }
+        }
+
+        if( !query->stack_count ) {
+            physics_counter_add( stats, PHYSICS_COUNTER_BOUNDS_TESTS, bounds_tests );
+            return false;
+        }
+
+        const struct BVHNode* node = bvh->nodes + query->stack[--query->stack_count];
+        bounds_tests++;
+        if( !CheckCollisionBoxes( query->box, node->bounds ) ) {
+            continue;
+        }
+
+        if( node->count ) {
+            query->leaf_at  = node->first;
+            query->leaf_end = node->first + node->count;
+        } else {
+            query->stack[query->stack_count++] = node->first + 1;
+            query->stack[query->stack_count++] = node->first;
+        }
+    }
+}
+
+void collision_cache_store( struct CollisionCache* cache, usize object, i32 triangle ) {
+    cache->valid    = true;
+    cache->object   = object;
+    cache->triangle = triangle;
+}
+void collision_cache_invalidate( struct CollisionCache* cache ) {
+    cache->valid    = false;
+    cache->object   = 0;
+    cache->triangle = 0;
+}
+void capsule_cache_invalidate( struct CapsuleCache* cache ) {
+    memset( cache, 0, sizeof(*cache) );
+}
+f32 cache_counters_hit_rate( const struct CacheCounters* counters ) {
+    u64 total = counters->hits + counters->misses;
+    if( !total ) {
+        return 0.0f;
+    }
+    return (f64)counters->hits / (f64)total;
+}
+
@@ -7,6 +7,7 @@
  * @date   August 17, 2024
 */
 #include "common.h"
+#include "job.h"
 
 Vector3 velocity_apply_drag( Vector3 velocity, f32 drag, f32 dt );
 Vector3 velocity_clamp_horizontal( Vector3 velocity, f32 max );
@@ -17,13 +18,78 @@ struct Capsule {
     f32     radius;
 };
 
+struct CapsuleQuery {
+    Vector3 start;
+    Vector3 end;
+    f32     radius;
+};
+
 struct CollisionResult {
     b32     hit;
     Vector3 normal;
     Vector3 point;
     f32     distance;
+    i32     triangle;
+};
+
+struct CollisionCache {
+    b32   valid;
+    usize object;
+    i32   triangle;
+};
+
+#define CAPSULE_CACHE_MAX_CANDIDATES (32)
+#define CAPSULE_CACHE_MARGIN (0.25f)
+
+/// Every triangle that could touch a capsule inside bounds,
+/// in the order a full level query would test them.
+struct CapsuleCache {
+    b32         valid;
+    BoundingBox bounds;
+    u32         count;
+    u32         objects[CAPSULE_CACHE_MAX_CANDIDATES];
+    u32         triangles[CAPSULE_CACHE_MAX_CANDIDATES];
+};
+
+/// Kept outside of caches so restoring a snapshot doesn't reset them.
+struct CacheCounters {
+    u64 hits;
+    u64 misses;
 };
 
+enum PhysicsCounter {
+    /// Level objects handed to narrowphase.
+    PHYSICS_COUNTER_OBJECTS,
+    /// Box tests against BVH nodes and object bounds.
+    PHYSICS_COUNTER_BOUNDS_TESTS,
+    /// Triangles tested against capsules or rays.
+    PHYSICS_COUNTER_TRIANGLES,
+    PHYSICS_COUNTER_RAYS,
+    PHYSICS_COUNTER_HITS,
+
+    PHYSICS_COUNTER_COUNT
+};
+struct PhysicsCounters {
+    u64 values[PHYSICS_COUNTER_COUNT];
+};
+
+// NOTE(alicia): one cache line per thread so workers
+// don't fight over counters.
+struct PhysicsCountersSlot {
+    struct PhysicsCounters counters;
+} __attribute__((aligned(64)));
+/// Counters of one game instance, kept per job thread and
+/// summed by physics_stats_read. Queries given NULL stats don't count.
+struct PhysicsStats {
+    struct PhysicsCountersSlot slots[JOB_MAX_THREADS];
+};
+
+void physics_counter_add( struct PhysicsStats* stats, enum PhysicsCounter counter, u64 amount );
+/// Reset and read only while no physics jobs are running on stats.
+void physics_stats_reset( struct PhysicsStats* stats );
+struct PhysicsCounters physics_stats_read( const struct PhysicsStats* stats );
+const char* physics_counter_name( enum PhysicsCounter counter );
+
 struct CollisionResult collision_sphere_triangle(
     Vector3 position, f32 radius,
     Vector3 p0, Vector3 p1, Vector3 p2 );
@@ -38,6 +104,137 @@ struct CollisionResult collision_capsule_triangle(
 
 struct CollisionResult collision_capsule_mesh(
     Vector3 cap_start, Vector3 cap_end, f32 radius,
-    Matrix mesh_transform, Mesh mesh );
+    Matrix mesh_transform, Mesh mesh, struct PhysicsStats* stats );
+
+#define COLLISION_BVH_LEAF_SIZE (4)
+#define COLLISION_QUANTIZE_MAX (65535.0f)
+#define COLLISION_DEGENERATE_AREA (1e-12f)
+
+struct BVHNode {
+    BoundingBox bounds;
+    // NOTE(alicia): leaf: first triangle, internal: left child.
+    // right child is always first + 1.
+    u32 first;
+    u32 count;
+};
+/// Same as BVHNode but bounds are on the mesh's quantization grid.
+struct CollisionNode {
+    u16 min[3];
+    u16 max[3];
+    u32 first;
+    u32 count;
+};
+
+/// Positions and BVH bounds are 16-bit per axis, quantized over the mesh bounds.
+/// Indices are 16-bit unless the mesh has more than 65536 vertices.
+struct CollisionMesh {
+    u16*  positions;
+    void* indices;
+    b32   wide_indices;
+    u32   vertex_count;
+    u32   triangle_count;
+
+    Vector3 quantize_origin;
+    Vector3 quantize_scale;
+
+    struct CollisionNode* nodes;
+    u32                   node_count;
+
+    u32   source_vertex_count;
+    u32   source_triangle_count;
+    /// size of the raylib mesh positions and indices it was built from.
+    usize source_memory;
+};
+
+/// quantizes and welds vertices, drops degenerate triangles and
+/// stores triangles in BVH leaf order.
+b32  collision_mesh_create( Mesh mesh, struct CollisionMesh* out_mesh );
+void collision_mesh_destroy( struct CollisionMesh* mesh );
+BoundingBox collision_mesh_bounds( const struct CollisionMesh* mesh );
+usize collision_mesh_memory( const struct CollisionMesh* mesh );
+Vector3 collision_mesh_vertex( const struct CollisionMesh* mesh, u32 vertex );
+void collision_mesh_triangle(
+    const struct CollisionMesh* mesh, u32 triangle,
+    Vector3* out_p0, Vector3* out_p1, Vector3* out_p2 );
+/// collects triangles in leaves overlapping box, returns count written.
+u32 collision_mesh_query_box(
+    const struct CollisionMesh* mesh, BoundingBox box, struct PhysicsStats* stats,
+    u32* out_triangles, u32 max_triangles );
+
+/// transform is mesh to world, inverse is world to mesh.
+struct CollisionResult collision_mesh_capsule(
+    Vector3 cap_start, Vector3 cap_end, f32 radius,
+    const struct CollisionMesh* mesh, Matrix transform, Matrix inverse,
+    struct PhysicsStats* stats );
+struct CollisionResult collision_mesh_capsule_triangle(
+    Vector3 cap_start, Vector3 cap_end, f32 radius,
+    const struct CollisionMesh* mesh, Matrix transform, i32 triangle,
+    struct PhysicsStats* stats );
+
+RayCollision collision_mesh_ray(
+    Ray ray, f32 max_distance,
+    const struct CollisionMesh* mesh, Matrix inverse,
+    struct PhysicsStats* stats, i32* out_triangle );
+RayCollision collision_mesh_ray_triangle(
+    Ray ray, const struct CollisionMesh* mesh, Matrix inverse, i32 triangle,
+    struct PhysicsStats* stats );
+
+#define LEVEL_BVH_LEAF_SIZE (2)
+#define LEVEL_BVH_REBUILD_RATIO (1.5f)
+#define LEVEL_BVH_STACK_SIZE (64)
+
+struct LevelBVH {
+    struct BVHNode* nodes;
+    u32             node_count;
+
+    // NOTE(alicia): leaf slot -> object index.
+    u32* order;
+    u32  order_count;
+
+    // NOTE(alicia): world space bounds indexed by object.
+    BoundingBox* bounds;
+    u32          object_count;
+
+    f32 build_cost;
+    f32 cost;
+
+    u64 refit_count;
+    u64 rebuild_count;
+};
+
+struct LevelBVHQuery {
+    const struct LevelBVH* bvh;
+    BoundingBox box;
+    struct PhysicsStats* stats;
+
+    u32 stack[LEVEL_BVH_STACK_SIZE];
+    u32 stack_count;
+
+    u32 leaf_at;
+    u32 leaf_end;
+};
+
+/// objects whose enabled entry is false are left out of the tree.
+void level_bvh_create(
+    struct LevelBVH* out_bvh, const BoundingBox* bounds,
+    const b32* enabled, u32 object_count );
+void level_bvh_destroy( struct LevelBVH* bvh );
+/// Deep copy, clone can be refit independently of source.
+void level_bvh_clone( const struct LevelBVH* source, struct LevelBVH* out_bvh );
+void level_bvh_rebuild( struct LevelBVH* bvh );
+void level_bvh_set_bounds( struct LevelBVH* bvh, u32 object, BoundingBox bounds );
+/// bottom-up refit, rebuilds tree when it degrades
+/// past LEVEL_BVH_REBUILD_RATIO of the freshly built cost.
+void level_bvh_refit( struct LevelBVH* bvh );
+
+void level_bvh_query(
+    const struct LevelBVH* bvh, BoundingBox box,
+    struct PhysicsStats* stats, struct LevelBVHQuery* out_query );
+b32 level_bvh_query_next( struct LevelBVHQuery* query, u32* out_object );
+
+void collision_cache_store( struct CollisionCache* cache, usize object, i32 triangle );
+void collision_cache_invalidate( struct CollisionCache* cache );
+void capsule_cache_invalidate( struct CapsuleCache* cache );
+f32  cache_counters_hit_rate( const struct CacheCounters* counters );
 
 #endif /* header guard */
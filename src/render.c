@@ -0,0 +1,468 @@
+/**
+ * @file   render.c
+ * @brief  Batched level rendering.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 19, 2026
+*/
+#include "render.h"
+#include "mathex.h"
+#include "rlgl.h"
+// IWYU pragma: begin_keep
+#include <string.h>
+// IWYU pragma: end_keep
+
+#define INSTANCE_BATCH_START_CAPACITY (16)
+
+b32 render_instanced_shader_load( Shader* out_shader ) {
+    memset( out_shader, 0, sizeof(*out_shader) );
+
+    // NOTE(alicia): GLES2 only has instancing through an extension
+    // and GL 1.1 has no shaders at all, don't bother with either.
+    int version = rlGetVersion();
+    if( version == RL_OPENGL_11 || version == RL_OPENGL_ES_20 ) {
+        TraceLog( LOG_INFO, "Instancing not available, drawing instances one by one." );
+        return false;
+    }
+
+    Shader shader = LoadShader( RENDER_INSTANCED_VS_PATH, RENDER_INSTANCED_FS_PATH );
+    if( !render_instanced_shader_valid( shader ) ) {
+        TraceLog( LOG_WARNING, "Failed to load instancing shader!" );
+        return false;
+    }
+    shader.locs[SHADER_LOC_MATRIX_MVP] = GetShaderLocation( shader, "mvp" );
+    shader.locs[SHADER_LOC_MATRIX_MODEL] =
+        GetShaderLocationAttrib( shader, "instanceTransform" );
+
+    *out_shader = shader;
+    return true;
+}
+b32 render_instanced_shader_valid( Shader shader ) {
+    return shader.id && shader.id != rlGetShaderIdDefault();
+}
+
+void instance_batch_create( struct InstanceBatch* out_batch, Model model ) {
+    memset( out_batch, 0, sizeof(*out_batch) );
+    out_batch->model      = model;
+    out_batch->capacity   = INSTANCE_BATCH_START_CAPACITY;
+    out_batch->transforms = MemAlloc( sizeof(Matrix) * out_batch->capacity );
+}
+void instance_batch_destroy( struct InstanceBatch* batch ) {
+    MemFree( batch->transforms );
+    memset( batch, 0, sizeof(*batch) );
+}
+void instance_batch_clear( struct InstanceBatch* batch ) {
+    batch->count = 0;
+}
+void instance_batch_push( struct InstanceBatch* batch, Matrix transform ) {
+    if( batch->count >= batch->capacity ) {
+        batch->capacity  *= 2;
+        batch->transforms =
+            MemRealloc( batch->transforms, sizeof(Matrix) * batch->capacity );
+    }
+    batch->transforms[batch->count++] = transform;
+}
+u32 instance_batch_draw( struct InstanceBatch* batch, Shader shader, Color tint ) {
+    if( !batch->count ) {
+        return 0;
+    }
+
+    b32 instanced = render_instanced_shader_valid( shader );
+    u32 draw_calls = 0;
+    for( int i = 0; i < batch->model.meshCount; ++i ) {
+        Mesh      mesh     = batch->model.meshes[i];
+        Material  material = batch->model.materials[batch->model.meshMaterial[i]];
+        Color*    color    = &material.maps[MATERIAL_MAP_DIFFUSE].color;
+        Color     original = *color;
+
+        // NOTE(alicia): same tint DrawModel applies, material maps
+        // are shared with model so color has to be put back.
+        color->r = (u8)( ( (u32)original.r * tint.r ) / 255 );
+        color->g = (u8)( ( (u32)original.g * tint.g ) / 255 );
+        color->b = (u8)( ( (u32)original.b * tint.b ) / 255 );
+        color->a = (u8)( ( (u32)original.a * tint.a ) / 255 );
+
+        if( instanced ) {
+            material.shader = shader;
+            DrawMeshInstanced( mesh, material, batch->transforms, (int)batch->count );
+            draw_calls++;
+        } else {
+            for( u32 instance = 0; instance < batch->count; ++instance ) {
+                DrawMesh( mesh, material, batch->transforms[instance] );
+            }
+            draw_calls += batch->count;
+        }
+
+        *color = original;
+    }
+    return draw_calls;
+}
+
+struct StaticChunkBuilder {
+    u32 material;
+    int cell[3];
+
+    f32* vertices;
+    f32* texcoords;
+    f32* normals;
+    u8*  colors;
+    u32  vertex_count;
+    u32  vertex_capacity;
+
+    BoundingBox bounds;
+};
+
+static b32 static_material_eq( Material a, Material b ) {
+    Texture a_texture = a.maps[MATERIAL_MAP_DIFFUSE].texture;
+    Texture b_texture = b.maps[MATERIAL_MAP_DIFFUSE].texture;
+    Color   a_color   = a.maps[MATERIAL_MAP_DIFFUSE].color;
+    Color   b_color   = b.maps[MATERIAL_MAP_DIFFUSE].color;
+    return
+        a.shader.id  == b.shader.id  &&
+        a_texture.id == b_texture.id &&
+        a_color.r == b_color.r && a_color.g == b_color.g &&
+        a_color.b == b_color.b && a_color.a == b_color.a;
+}
+static struct StaticChunkBuilder* static_chunk_find(
+    struct StaticChunkBuilder** builders, u32* count, u32* capacity,
+    u32 material, const int cell[3]
+) {
+    for( u32 i = 0; i < *count; ++i ) {
+        struct StaticChunkBuilder* builder = *builders + i;
+        if(
+            builder->material == material &&
+            builder->cell[0] == cell[0] &&
+            builder->cell[1] == cell[1] &&
+            builder->cell[2] == cell[2]
+        ) {
+            return builder;
+        }
+    }
+
+    if( *count >= *capacity ) {
+        *capacity = *capacity ? *capacity * 2 : 16;
+        *builders = MemRealloc(
+            *builders, sizeof(struct StaticChunkBuilder) * *capacity );
+    }
+    struct StaticChunkBuilder* builder = *builders + (*count)++;
+    memset( builder, 0, sizeof(*builder) );
+    builder->material = material;
+    memcpy( builder->cell, cell, sizeof(builder->cell) );
+    return builder;
+}
+static void static_chunk_push(
+    struct StaticChunkBuilder* builder, const Mesh* mesh,
+    Matrix transform, Matrix inverse, const u32 indices[3]
+) {
+    if( builder->vertex_count + 3 > builder->vertex_capacity ) {
+        u32 capacity = builder->vertex_capacity ? builder->vertex_capacity * 2 : 192;
+        builder->vertices  = MemRealloc( builder->vertices,  sizeof(f32) * 3 * capacity );
+        builder->texcoords = MemRealloc( builder->texcoords, sizeof(f32) * 2 * capacity );
+        builder->normals   = MemRealloc( builder->normals,   sizeof(f32) * 3 * capacity );
+        builder->colors    = MemRealloc( builder->colors,    sizeof(u8)  * 4 * capacity );
+        builder->vertex_capacity = capacity;
+    }
+
+    for( u32 i = 0; i < 3; ++i ) {
+        u32 src = indices[i];
+        u32 dst = builder->vertex_count++;
+
+        Vector3 position = Vector3Transform(
+            *(Vector3*)( mesh->vertices + src * 3 ), transform );
+        memcpy( builder->vertices + dst * 3, &position, sizeof(position) );
+
+        if( dst ) {
+            builder->bounds.min = Vector3Min( builder->bounds.min, position );
+            builder->bounds.max = Vector3Max( builder->bounds.max, position );
+        } else {
+            builder->bounds.min = builder->bounds.max = position;
+        }
+
+        Vector3 normal = v3_up();
+        if( mesh->normals ) {
+            normal = v3_transform_normal(
+                *(Vector3*)( mesh->normals + src * 3 ), inverse );
+        }
+        memcpy( builder->normals + dst * 3, &normal, sizeof(normal) );
+
+        if( mesh->texcoords ) {
+            memcpy( builder->texcoords + dst * 2,
+                mesh->texcoords + src * 2, sizeof(f32) * 2 );
+        } else {
+            memset( builder->texcoords + dst * 2, 0, sizeof(f32) * 2 );
+        }
+
+        if( mesh->colors ) {
+            memcpy( builder->colors + dst * 4, mesh->colors + src * 4, 4 );
+        } else {
+            memset( builder->colors + dst * 4, 255, 4 );
+        }
+    }
+}
+
+void static_geometry_build(
+    struct StaticGeometry* out_geometry,
+    const Model* models, const Matrix* transforms, u32 model_count
+) {
+    memset( out_geometry, 0, sizeof(*out_geometry) );
+
+    Material* materials        = NULL;
+    u32       material_count   = 0;
+    u32       material_capacity = 0;
+
+    struct StaticChunkBuilder* builders = NULL;
+    u32 builder_count    = 0;
+    u32 builder_capacity = 0;
+
+    for( u32 model_index = 0; model_index < model_count; ++model_index ) {
+        const Model* model = models + model_index;
+        Matrix transform   = transforms[model_index];
+        Matrix inverse     = MatrixInvert( transform );
+
+        for( int mesh_index = 0; mesh_index < model->meshCount; ++mesh_index ) {
+            const Mesh* mesh = model->meshes + mesh_index;
+            if( !mesh->vertices ) {
+                continue;
+            }
+
+            // NOTE(alicia): models are loaded separately so materials
+            // are never the same pointer, compare what gets bound instead.
+            Material material = model->materials[model->meshMaterial[mesh_index]];
+            u32 material_slot = 0;
+            for( ; material_slot < material_count; ++material_slot ) {
+                if( static_material_eq( materials[material_slot], material ) ) {
+                    break;
+                }
+            }
+            if( material_slot == material_count ) {
+                if( material_count >= material_capacity ) {
+                    material_capacity = material_capacity ? material_capacity * 2 : 8;
+                    materials = MemRealloc(
+                        materials, sizeof(Material) * material_capacity );
+                }
+                materials[material_count++] = material;
+            }
+
+            for( int triangle = 0; triangle < mesh->triangleCount; ++triangle ) {
+                u32 indices[3];
+                for( u32 i = 0; i < 3; ++i ) {
+                    u32 corner = (u32)triangle * 3 + i;
+                    indices[i] = mesh->indices ? mesh->indices[corner] : corner;
+                }
+
+                Vector3 centroid = v3_zero();
+                for( u32 i = 0; i < 3; ++i ) {
+                    centroid = Vector3Add( centroid, Vector3Transform(
+                        *(Vector3*)( mesh->vertices + indices[i] * 3 ), transform ) );
+                }
+                centroid = Vector3Scale( centroid, 1.0f / 3.0f );
+
+                int cell[3] = {
+                    (int)floorf( centroid.x / RENDER_STATIC_CHUNK_SIZE ),
+                    (int)floorf( centroid.y / RENDER_STATIC_CHUNK_SIZE ),
+                    (int)floorf( centroid.z / RENDER_STATIC_CHUNK_SIZE ),
+                };
+                struct StaticChunkBuilder* builder = static_chunk_find(
+                    &builders, &builder_count, &builder_capacity,
+                    material_slot, cell );
+                static_chunk_push( builder, mesh, transform, inverse, indices );
+            }
+        }
+    }
+
+    if( builder_count ) {
+        out_geometry->chunks = MemAlloc( sizeof(struct StaticChunk) * builder_count );
+    }
+    for( u32 i = 0; i < builder_count; ++i ) {
+        struct StaticChunkBuilder* builder = builders + i;
+        struct StaticChunk*        chunk   = out_geometry->chunks + i;
+
+        // NOTE(alicia): triangles are not indexed, raylib indices
+        // are 16-bit and chunks can go past that.
+        memset( chunk, 0, sizeof(*chunk) );
+        chunk->mesh.vertexCount   = (int)builder->vertex_count;
+        chunk->mesh.triangleCount = (int)( builder->vertex_count / 3 );
+        chunk->mesh.vertices      = builder->vertices;
+        chunk->mesh.texcoords     = builder->texcoords;
+        chunk->mesh.normals       = builder->normals;
+        chunk->mesh.colors        = builder->colors;
+        UploadMesh( &chunk->mesh, false );
+
+        chunk->material = materials[builder->material];
+        chunk->bounds   = builder->bounds;
+    }
+    out_geometry->chunk_count = builder_count;
+
+    TraceLog( LOG_INFO, "Merged %u static models into %u chunks, %u materials.",
+        model_count, builder_count, material_count );
+
+    MemFree( builders );
+    MemFree( materials );
+}
+void static_geometry_destroy( struct StaticGeometry* geometry ) {
+    for( u32 i = 0; i < geometry->chunk_count; ++i ) {
+        UnloadMesh( geometry->chunks[i].mesh );
+    }
+    MemFree( geometry->chunks );
+    memset( geometry, 0, sizeof(*geometry) );
+}
+
+b32 dynamic_resolution_create(
+    struct DynamicResolution* out_resolution, int width, int height
+) {
+    memset( out_resolution, 0, sizeof(*out_resolution) );
+    out_resolution->scale       = 1.0f;
+    out_resolution->enabled     = true;
+    out_resolution->up_delay    = RENDER_SCALE_UP_DELAY;
+    out_resolution->probe_time  = -1.0f;
+    out_resolution->frame_time  = RENDER_FRAME_BUDGET;
+    out_resolution->change_from = 1.0f;
+    out_resolution->change_to   = 1.0f;
+
+    if( rlGetVersion() == RL_OPENGL_11 ) {
+        TraceLog( LOG_INFO, "Render textures not available, rendering at window size." );
+        return false;
+    }
+    dynamic_resolution_resize( out_resolution, width, height );
+    return out_resolution->target.id != 0;
+}
+void dynamic_resolution_destroy( struct DynamicResolution* resolution ) {
+    if( resolution->target.id ) {
+        UnloadRenderTexture( resolution->target );
+    }
+    memset( resolution, 0, sizeof(*resolution) );
+}
+void dynamic_resolution_resize(
+    struct DynamicResolution* resolution, int width, int height
+) {
+    if(
+        ( width == resolution->width && height == resolution->height ) ||
+        width <= 0 || height <= 0 ||
+        rlGetVersion() == RL_OPENGL_11
+    ) {
+        return;
+    }
+    resolution->width  = width;
+    resolution->height = height;
+
+    if( resolution->target.id ) {
+        UnloadRenderTexture( resolution->target );
+    }
+    resolution->target = LoadRenderTexture( width, height );
+    if( !IsRenderTextureReady( resolution->target ) ) {
+        TraceLog( LOG_WARNING, "Failed to create %ix%i render target!", width, height );
+        memset( &resolution->target, 0, sizeof(resolution->target) );
+        return;
+    }
+    SetTextureFilter( resolution->target.texture, TEXTURE_FILTER_BILINEAR );
+}
+b32 dynamic_resolution_update( struct DynamicResolution* resolution, f32 frame_time ) {
+    if( !resolution->target.id ) {
+        return false;
+    }
+
+    // NOTE(alicia): raylib has no GPU timer queries, frame time is the
+    // only signal. with frames capped it never shows how much time is
+    // left over, so higher scales are found by trying them.
+    // long frames are clamped so one hitch can't scale down alone.
+    f32 max_frame_time = RENDER_FRAME_BUDGET * 2.0f;
+    frame_time = frame_time < max_frame_time ? frame_time : max_frame_time;
+    resolution->frame_time =
+        Lerp( resolution->frame_time, frame_time, RENDER_FRAME_SMOOTHING );
+
+    f32 scale = resolution->scale;
+    if( !resolution->enabled ) {
+        scale = 1.0f;
+    } else {
+        if( resolution->frame_time > RENDER_FRAME_BUDGET * RENDER_FRAME_OVER ) {
+            resolution->over_time += frame_time;
+            resolution->under_time = 0.0f;
+        } else {
+            resolution->under_time += frame_time;
+            resolution->over_time   = 0.0f;
+        }
+
+        if( resolution->probe_time >= 0.0f ) {
+            resolution->probe_time += frame_time;
+            if( resolution->probe_time >= RENDER_SCALE_UP_DELAY ) {
+                resolution->probe_time = -1.0f;
+                resolution->up_delay   = RENDER_SCALE_UP_DELAY;
+            }
+        }
+
+        if(
+            resolution->over_time >= RENDER_SCALE_DOWN_DELAY &&
+            scale > RENDER_SCALE_MIN
+        ) {
+            scale -= RENDER_SCALE_STEP;
+            if( resolution->probe_time >= 0.0f ) {
+                resolution->up_delay *= 2.0f;
+                if( resolution->up_delay > RENDER_SCALE_UP_DELAY_MAX ) {
+                    resolution->up_delay = RENDER_SCALE_UP_DELAY_MAX;
+                }
+            }
+            resolution->probe_time = -1.0f;
+        } else if( resolution->under_time >= resolution->up_delay && scale < 1.0f ) {
+            scale += RENDER_SCALE_STEP;
+            resolution->probe_time = 0.0f;
+        }
+        scale = Clamp( scale, RENDER_SCALE_MIN, 1.0f );
+    }
+
+    if( scale == resolution->scale ) {
+        return false;
+    }
+    resolution->change_from       = resolution->scale;
+    resolution->change_to         = scale;
+    resolution->change_frame_time = resolution->frame_time;
+    resolution->change_at         = GetTime();
+    resolution->change_count++;
+    resolution->scale      = scale;
+    resolution->over_time  = 0.0f;
+    resolution->under_time = 0.0f;
+
+    int width, height;
+    dynamic_resolution_size( resolution, &width, &height );
+    TraceLog( LOG_INFO, "Render scale %.0f%% -> %.0f%% (%ix%i), frame %.1fms, budget %.1fms",
+        resolution->change_from * 100.0f, scale * 100.0f, width, height,
+        resolution->change_frame_time * 1000.0f, RENDER_FRAME_BUDGET * 1000.0f );
+    return true;
+}
+void dynamic_resolution_size(
+    const struct DynamicResolution* resolution, int* out_width, int* out_height
+) {
+    int width  = (int)( (f32)resolution->width  * resolution->scale + 0.5f );
+    int height = (int)( (f32)resolution->height * resolution->scale + 0.5f );
+    *out_width  = width  > 1 ? width  : 1;
+    *out_height = height > 1 ? height : 1;
+}
+void dynamic_resolution_begin( struct DynamicResolution* resolution ) {
+    if( !resolution->target.id ) {
+        return;
+    }
+    int width, height;
+    dynamic_resolution_size( resolution, &width, &height );
+
+    // NOTE(alicia): target keeps window's aspect ratio so
+    // BeginMode3D's projection is still right for the corner.
+    BeginTextureMode( resolution->target );
+    rlViewport( 0, 0, width, height );
+}
+void dynamic_resolution_end( struct DynamicResolution* resolution ) {
+    if( !resolution->target.id ) {
+        return;
+    }
+    EndTextureMode();
+
+    int width, height;
+    dynamic_resolution_size( resolution, &width, &height );
+    Rectangle source = { 0.0f, 0.0f, (f32)width, -(f32)height };
+    Rectangle dest   = { 0.0f, 0.0f, (f32)GetScreenWidth(), (f32)GetScreenHeight() };
+
+    // NOTE(alicia): alpha in target is whatever blending left
+    // behind, copy it as is instead of blending it with screen.
+    rlDrawRenderBatchActive();
+    rlDisableColorBlend();
+    DrawTexturePro( resolution->target.texture, source, dest, v2_zero(), 0.0f, WHITE );
+    rlDrawRenderBatchActive();
+    rlEnableColorBlend();
+}
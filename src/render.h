@@ -0,0 +1,117 @@
+#if !defined(RENDER_H)
+#define RENDER_H
+/**
+ * @file   render.h
+ * @brief  Batched level rendering.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 19, 2026
+*/
+#include "common.h"
+#include "raylib.h"
+
+#define RENDER_INSTANCED_VS_PATH "resources/shaders/instanced.vs"
+#define RENDER_INSTANCED_FS_PATH "resources/shaders/textured.fs"
+
+/// Width of grid cells static geometry is split into.
+#define RENDER_STATIC_CHUNK_SIZE (16.0f)
+
+/// Transforms of every visible object that shares one model.
+struct InstanceBatch {
+    Model   model;
+    Matrix* transforms;
+    u32     count;
+    u32     capacity;
+};
+
+/// Load shader with per-instance transform attribute.
+/// Returns false if instancing is not available,
+/// batches then fall back to one draw per instance.
+b32  render_instanced_shader_load( Shader* out_shader );
+b32  render_instanced_shader_valid( Shader shader );
+
+/// Model is borrowed, batch never unloads it.
+void instance_batch_create( struct InstanceBatch* out_batch, Model model );
+void instance_batch_destroy( struct InstanceBatch* batch );
+void instance_batch_clear( struct InstanceBatch* batch );
+void instance_batch_push( struct InstanceBatch* batch, Matrix transform );
+/// Draw every pushed transform, one draw per mesh when shader is valid.
+/// Returns number of draw calls submitted.
+u32  instance_batch_draw( struct InstanceBatch* batch, Shader shader, Color tint );
+
+/// World space triangles from one grid cell that share a material.
+struct StaticChunk {
+    Mesh        mesh;
+    /// Borrowed from source model.
+    Material    material;
+    BoundingBox bounds;
+};
+/// Static models merged into one mesh per material and grid cell.
+struct StaticGeometry {
+    struct StaticChunk* chunks;
+    u32 chunk_count;
+};
+
+/// Bake transforms into copies of every mesh in models and upload them.
+/// Source models must outlive geometry since materials are borrowed.
+void static_geometry_build(
+    struct StaticGeometry* out_geometry,
+    const Model* models, const Matrix* transforms, u32 model_count );
+void static_geometry_destroy( struct StaticGeometry* geometry );
+
+/// Frame time dynamic resolution tries to stay under.
+#define RENDER_FRAME_BUDGET (1.0f / 60.0f)
+/// Smoothed frame time has to pass budget by this much to count as over.
+#define RENDER_FRAME_OVER (1.1f)
+/// Weight of newest frame in smoothed frame time.
+#define RENDER_FRAME_SMOOTHING (0.1f)
+#define RENDER_SCALE_MIN  (0.5f)
+#define RENDER_SCALE_STEP (0.125f)
+/// Seconds over budget before scaling down.
+#define RENDER_SCALE_DOWN_DELAY (0.25f)
+/// Seconds under budget before trying next scale up,
+/// doubles every time scaling up goes over budget again.
+#define RENDER_SCALE_UP_DELAY     (2.0f)
+#define RENDER_SCALE_UP_DELAY_MAX (16.0f)
+
+/// 3D pass renders into corner of a window sized target at a fraction
+/// of window resolution, scaled from frame time against budget.
+struct DynamicResolution {
+    /// Zero if render textures are not available, pass draws to screen then.
+    RenderTexture2D target;
+    int width;
+    int height;
+
+    f32 scale;
+    b32 enabled;
+
+    f32 frame_time;
+    f32 over_time;
+    f32 under_time;
+    f32 up_delay;
+    /// Seconds since last scale up, negative once it has held.
+    f32 probe_time;
+
+    /// Last scale change, shown on perf overlay.
+    f32 change_from;
+    f32 change_to;
+    f32 change_frame_time;
+    f64 change_at;
+    u32 change_count;
+};
+
+/// Returns false if render textures are not available.
+b32  dynamic_resolution_create( struct DynamicResolution* out_resolution, int width, int height );
+void dynamic_resolution_destroy( struct DynamicResolution* resolution );
+/// Recreate target if window size changed.
+void dynamic_resolution_resize( struct DynamicResolution* resolution, int width, int height );
+/// Feed last frame's time. Returns true if scale changed.
+b32  dynamic_resolution_update( struct DynamicResolution* resolution, f32 frame_time );
+/// Size 3D pass renders at.
+void dynamic_resolution_size(
+    const struct DynamicResolution* resolution, int* out_width, int* out_height );
+/// Start drawing into target, draws to screen if there is no target.
+void dynamic_resolution_begin( struct DynamicResolution* resolution );
+/// Stop drawing into target and stretch it over window.
+void dynamic_resolution_end( struct DynamicResolution* resolution );
+
+#endif /* header guard */
@@ -0,0 +1,392 @@
+/**
+ * @file   replay.c
+ * @brief  Input recording and playback.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 18, 2026
+*/
+#include "replay.h"
+#include "mathex.h"
+// IWYU pragma: begin_keep
+#include <string.h>
+// IWYU pragma: end_keep
+
+#define REPLAY_BUTTON_JUMP        (1 << 0)
+#define REPLAY_BUTTON_JUMP_HOLD   (1 << 1)
+#define REPLAY_BUTTON_IS_MOVING   (1 << 2)
+#define REPLAY_BUTTON_RUN_HOLD    (1 << 3)
+#define REPLAY_BUTTON_RESIZE_HOLD (1 << 4)
+/// Move changed since last frame, followed by xor of float bits as varints.
+#define REPLAY_FRAME_MOVE         (1 << 5)
+/// Rotation is not zero, followed by zigzag varints.
+#define REPLAY_FRAME_ROTATION     (1 << 6)
+/// Rotation has a fraction, stored as raw float bits instead.
+#define REPLAY_FRAME_ROTATION_RAW (1 << 7)
+// NOTE(alicia): flags are a varint, rarely used bits go past
+// the first seven so common frames stay one byte.
+#define REPLAY_BUTTON_REWIND_HOLD (1 << 8)
+
+struct ReplayFileHeader {
+    u32 magic;
+    u32 version;
+    u32 level;
+    f32 tick_dt;
+    u32 frame_count;
+    u32 keyframe_interval;
+    u32 keyframe_count;
+    u32 input_size;
+};
+struct ReplayFileKeyframe {
+    u32 tick;
+    u32 snapshot_size;
+};
+
+struct ReplayWriter {
+    u8*   data;
+    usize size;
+    usize capacity;
+};
+static void replay_write( struct ReplayWriter* writer, const void* data, usize size ) {
+    if( writer->size + size > writer->capacity ) {
+        usize capacity = writer->capacity ? writer->capacity * 2 : 4096;
+        while( capacity < writer->size + size ) {
+            capacity *= 2;
+        }
+        writer->data     = MemRealloc( writer->data, capacity );
+        writer->capacity = capacity;
+    }
+    memcpy( writer->data + writer->size, data, size );
+    writer->size += size;
+}
+static void replay_write_varint( struct ReplayWriter* writer, u32 value ) {
+    u8 bytes[5];
+    u32 count = 0;
+    do {
+        u8 byte = value & 0x7F;
+        value >>= 7;
+        bytes[count++] = byte | ( value ? 0x80 : 0 );
+    } while( value );
+    replay_write( writer, bytes, count );
+}
+
+struct ReplayReader {
+    const u8* at;
+    const u8* end;
+    b32 overflow;
+};
+static u8 replay_read_u8( struct ReplayReader* reader ) {
+    if( reader->at >= reader->end ) {
+        reader->overflow = true;
+        return 0;
+    }
+    return *reader->at++;
+}
+static u32 replay_read_varint( struct ReplayReader* reader ) {
+    u32 value = 0;
+    for( u32 shift = 0; shift < 35; shift += 7 ) {
+        u8 byte = replay_read_u8( reader );
+        value |= (u32)( byte & 0x7F ) << shift;
+        if( !( byte & 0x80 ) ) {
+            return value;
+        }
+    }
+    reader->overflow = true;
+    return value;
+}
+
+static u32 f32_bits( f32 value ) {
+    u32 bits;
+    memcpy( &bits, &value, sizeof(bits) );
+    return bits;
+}
+static f32 f32_from_bits( u32 bits ) {
+    f32 value;
+    memcpy( &value, &bits, sizeof(value) );
+    return value;
+}
+static u32 zigzag_encode( i32 value ) {
+    return ( (u32)value << 1 ) ^ (u32)( value >> 31 );
+}
+static i32 zigzag_decode( u32 value ) {
+    return (i32)( value >> 1 ) ^ -(i32)( value & 1 );
+}
+// NOTE(alicia): mouse deltas are whole pixels almost every frame.
+// compares bits so -0.0 is not mistaken for 0.
+static b32 f32_is_small_integer( f32 value ) {
+    return
+        absf( value ) < 1000000.0f &&
+        f32_bits( value ) == f32_bits( (f32)(i32)value );
+}
+
+static void replay_encode_input(
+    struct ReplayWriter* writer, const struct Input* input, const struct Input* last
+) {
+    u32 flags =
+        ( input->jump        ? REPLAY_BUTTON_JUMP        : 0 ) |
+        ( input->jump_hold   ? REPLAY_BUTTON_JUMP_HOLD   : 0 ) |
+        ( input->is_moving   ? REPLAY_BUTTON_IS_MOVING   : 0 ) |
+        ( input->run_hold    ? REPLAY_BUTTON_RUN_HOLD    : 0 ) |
+        ( input->resize_hold ? REPLAY_BUTTON_RESIZE_HOLD : 0 ) |
+        ( input->rewind_hold ? REPLAY_BUTTON_REWIND_HOLD : 0 );
+
+    u32 move_x = f32_bits( input->move.x ) ^ f32_bits( last->move.x );
+    u32 move_y = f32_bits( input->move.y ) ^ f32_bits( last->move.y );
+    if( move_x || move_y ) {
+        flags |= REPLAY_FRAME_MOVE;
+    }
+    if( f32_bits( input->rotation.x ) || f32_bits( input->rotation.y ) ) {
+        flags |= REPLAY_FRAME_ROTATION;
+        if(
+            !f32_is_small_integer( input->rotation.x ) ||
+            !f32_is_small_integer( input->rotation.y )
+        ) {
+            flags |= REPLAY_FRAME_ROTATION_RAW;
+        }
+    }
+
+    replay_write_varint( writer, flags );
+    if( flags & REPLAY_FRAME_MOVE ) {
+        replay_write_varint( writer, move_x );
+        replay_write_varint( writer, move_y );
+    }
+    if( flags & REPLAY_FRAME_ROTATION_RAW ) {
+        replay_write_varint( writer, f32_bits( input->rotation.x ) );
+        replay_write_varint( writer, f32_bits( input->rotation.y ) );
+    } else if( flags & REPLAY_FRAME_ROTATION ) {
+        replay_write_varint( writer, zigzag_encode( (i32)input->rotation.x ) );
+        replay_write_varint( writer, zigzag_encode( (i32)input->rotation.y ) );
+    }
+}
+static void replay_decode_input(
+    struct ReplayReader* reader, const struct Input* last, struct Input* out_input
+) {
+    memset( out_input, 0, sizeof(*out_input) );
+    u32 flags = replay_read_varint( reader );
+
+    out_input->jump        = ( flags & REPLAY_BUTTON_JUMP        ) != 0;
+    out_input->jump_hold   = ( flags & REPLAY_BUTTON_JUMP_HOLD   ) != 0;
+    out_input->is_moving   = ( flags & REPLAY_BUTTON_IS_MOVING   ) != 0;
+    out_input->run_hold    = ( flags & REPLAY_BUTTON_RUN_HOLD    ) != 0;
+    out_input->resize_hold = ( flags & REPLAY_BUTTON_RESIZE_HOLD ) != 0;
+    out_input->rewind_hold = ( flags & REPLAY_BUTTON_REWIND_HOLD ) != 0;
+
+    out_input->move = last->move;
+    if( flags & REPLAY_FRAME_MOVE ) {
+        u32 move_x = replay_read_varint( reader );
+        u32 move_y = replay_read_varint( reader );
+        out_input->move.x = f32_from_bits( f32_bits( last->move.x ) ^ move_x );
+        out_input->move.y = f32_from_bits( f32_bits( last->move.y ) ^ move_y );
+    }
+    if( flags & REPLAY_FRAME_ROTATION_RAW ) {
+        out_input->rotation.x = f32_from_bits( replay_read_varint( reader ) );
+        out_input->rotation.y = f32_from_bits( replay_read_varint( reader ) );
+    } else if( flags & REPLAY_FRAME_ROTATION ) {
+        out_input->rotation.x = (f32)zigzag_decode( replay_read_varint( reader ) );
+        out_input->rotation.y = (f32)zigzag_decode( replay_read_varint( reader ) );
+    }
+}
+
+void replay_begin( struct Replay* out_replay, u32 level, f32 tick_dt ) {
+    memset( out_replay, 0, sizeof(*out_replay) );
+    out_replay->level   = level;
+    out_replay->tick_dt = tick_dt;
+}
+static struct ReplayKeyframe* replay_keyframe_push( struct Replay* replay, u32 tick ) {
+    if( replay->keyframe_count >= replay->keyframe_capacity ) {
+        replay->keyframe_capacity =
+            replay->keyframe_capacity ? replay->keyframe_capacity * 2 : 16;
+        replay->keyframes = MemRealloc(
+            replay->keyframes, sizeof(struct ReplayKeyframe) * replay->keyframe_capacity );
+    }
+
+    struct ReplayKeyframe* keyframe = replay->keyframes + replay->keyframe_count++;
+    memset( keyframe, 0, sizeof(*keyframe) );
+    keyframe->tick = tick;
+    return keyframe;
+}
+void replay_keyframe( struct Replay* replay, const struct SceneGame* state ) {
+    u32 tick = replay->frame_count;
+    if(
+        tick % REPLAY_KEYFRAME_INTERVAL ||
+        tick / REPLAY_KEYFRAME_INTERVAL != replay->keyframe_count
+    ) {
+        return;
+    }
+    struct ReplayKeyframe* keyframe = replay_keyframe_push( replay, tick );
+    scene_game_snapshot_take( state, &keyframe->snapshot );
+}
+void replay_push( struct Replay* replay, const struct Input* input, u64 hash ) {
+    if( replay->frame_count >= replay->frame_capacity ) {
+        replay->frame_capacity = replay->frame_capacity ? replay->frame_capacity * 2 : 1024;
+        replay->frames = MemRealloc(
+            replay->frames, sizeof(struct ReplayFrame) * replay->frame_capacity );
+    }
+
+    struct ReplayFrame* frame = replay->frames + replay->frame_count++;
+    frame->input = *input;
+    frame->hash  = hash;
+}
+void replay_free( struct Replay* replay ) {
+    for( u32 i = 0; i < replay->keyframe_count; ++i ) {
+        scene_game_snapshot_free( &replay->keyframes[i].snapshot );
+    }
+    MemFree( replay->keyframes );
+    MemFree( replay->frames );
+    memset( replay, 0, sizeof(*replay) );
+}
+
+b32 replay_save( const struct Replay* replay, const char* path ) {
+    struct ReplayWriter inputs;
+    memset( &inputs, 0, sizeof(inputs) );
+
+    struct Input last;
+    memset( &last, 0, sizeof(last) );
+    for( u32 i = 0; i < replay->frame_count; ++i ) {
+        replay_encode_input( &inputs, &replay->frames[i].input, &last );
+        last = replay->frames[i].input;
+    }
+
+    struct ReplayFileHeader header;
+    memset( &header, 0, sizeof(header) );
+    header.magic             = REPLAY_FILE_MAGIC;
+    header.version           = REPLAY_FILE_VERSION;
+    header.level             = replay->level;
+    header.tick_dt           = replay->tick_dt;
+    header.frame_count       = replay->frame_count;
+    header.keyframe_interval = REPLAY_KEYFRAME_INTERVAL;
+    header.keyframe_count    = replay->keyframe_count;
+    header.input_size        = (u32)inputs.size;
+
+    struct ReplayWriter file;
+    memset( &file, 0, sizeof(file) );
+    replay_write( &file, &header, sizeof(header) );
+    for( u32 i = 0; i < replay->keyframe_count; ++i ) {
+        struct ReplayFileKeyframe keyframe;
+        keyframe.tick          = replay->keyframes[i].tick;
+        keyframe.snapshot_size = (u32)replay->keyframes[i].snapshot.size;
+        replay_write( &file, &keyframe, sizeof(keyframe) );
+    }
+    replay_write( &file, inputs.data, inputs.size );
+    for( u32 i = 0; i < replay->frame_count; ++i ) {
+        replay_write( &file, &replay->frames[i].hash, sizeof(u64) );
+    }
+    for( u32 i = 0; i < replay->keyframe_count; ++i ) {
+        const struct GameSnapshot* snapshot = &replay->keyframes[i].snapshot;
+        replay_write( &file, snapshot->data, snapshot->size );
+    }
+
+    b32 result = SaveFileData( path, file.data, file.size );
+    MemFree( file.data );
+    MemFree( inputs.data );
+    return result;
+}
+b32 replay_load( const char* path, struct Replay* out_replay ) {
+    memset( out_replay, 0, sizeof(*out_replay) );
+    if( !FileExists( path ) ) {
+        return false;
+    }
+
+    int data_size = 0;
+    unsigned char* data = LoadFileData( path, &data_size );
+    if( !data ) {
+        return false;
+    }
+
+    struct ReplayFileHeader header;
+    if( (usize)data_size < sizeof(header) ) {
+        UnloadFileData( data );
+        return false;
+    }
+    memcpy( &header, data, sizeof(header) );
+
+    usize keyframes_offset = sizeof(header);
+    usize inputs_offset    =
+        keyframes_offset + sizeof(struct ReplayFileKeyframe) * (usize)header.keyframe_count;
+    usize hashes_offset    = inputs_offset + header.input_size;
+    usize snapshots_offset = hashes_offset + sizeof(u64) * (usize)header.frame_count;
+
+    if(
+        header.magic != REPLAY_FILE_MAGIC ||
+        header.version != REPLAY_FILE_VERSION ||
+        header.keyframe_interval != REPLAY_KEYFRAME_INTERVAL ||
+        (usize)data_size < snapshots_offset
+    ) {
+        TraceLog( LOG_WARNING, "Replay %s is invalid or out of date!", path );
+        UnloadFileData( data );
+        return false;
+    }
+
+    replay_begin( out_replay, header.level, header.tick_dt );
+
+    struct ReplayReader reader;
+    reader.at       = data + inputs_offset;
+    reader.end      = data + hashes_offset;
+    reader.overflow = false;
+
+    struct Input last;
+    memset( &last, 0, sizeof(last) );
+    for( u32 i = 0; i < header.frame_count && !reader.overflow; ++i ) {
+        struct Input input;
+        replay_decode_input( &reader, &last, &input );
+
+        u64 hash;
+        memcpy( &hash, data + hashes_offset + sizeof(u64) * i, sizeof(hash) );
+        replay_push( out_replay, &input, hash );
+        last = input;
+    }
+
+    usize snapshot_at = snapshots_offset;
+    for( u32 i = 0; i < header.keyframe_count && !reader.overflow; ++i ) {
+        struct ReplayFileKeyframe file_keyframe;
+        memcpy(
+            &file_keyframe, data + keyframes_offset + sizeof(file_keyframe) * i,
+            sizeof(file_keyframe) );
+        if(
+            file_keyframe.tick != i * REPLAY_KEYFRAME_INTERVAL ||
+            snapshot_at + file_keyframe.snapshot_size > (usize)data_size
+        ) {
+            reader.overflow = true;
+            break;
+        }
+
+        struct ReplayKeyframe* keyframe = replay_keyframe_push( out_replay, file_keyframe.tick );
+        keyframe->snapshot.data     = MemAlloc( file_keyframe.snapshot_size );
+        keyframe->snapshot.size     = file_keyframe.snapshot_size;
+        keyframe->snapshot.capacity = file_keyframe.snapshot_size;
+        memcpy( keyframe->snapshot.data, data + snapshot_at, file_keyframe.snapshot_size );
+        snapshot_at += file_keyframe.snapshot_size;
+    }
+
+    UnloadFileData( data );
+    if( reader.overflow ) {
+        TraceLog( LOG_WARNING, "Replay %s is truncated!", path );
+        replay_free( out_replay );
+        return false;
+    }
+    return true;
+}
+
+u32 replay_seek( const struct Replay* replay, struct SceneGame* state, u32 tick ) {
+    if( tick > replay->frame_count ) {
+        tick = replay->frame_count;
+    }
+    if( !replay->keyframe_count ) {
+        return U32_MAX;
+    }
+
+    u32 keyframe = tick / REPLAY_KEYFRAME_INTERVAL;
+    if( keyframe >= replay->keyframe_count ) {
+        keyframe = replay->keyframe_count - 1;
+    }
+
+    if( !scene_game_snapshot_restore( state, &replay->keyframes[keyframe].snapshot ) ) {
+        return U32_MAX;
+    }
+    // NOTE(alicia): history before keyframe belongs to
+    // the timeline that was playing before the seek.
+    rewind_clear( &state->rewind );
+    float_env_init();
+    for( u32 i = replay->keyframes[keyframe].tick; i < tick; ++i ) {
+        scene_game_tick( replay->tick_dt, state, &replay->frames[i].input );
+    }
+    return tick;
+}
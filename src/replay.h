@@ -0,0 +1,61 @@
+#if !defined(REPLAY_H)
+#define REPLAY_H
+/**
+ * @file   replay.h
+ * @brief  Input recording and playback.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 18, 2026
+*/
+#include "common.h"
+#include "sc_game.h"
+
+#define REPLAY_FILE_MAGIC   (0x43455247) // GREC
+#define REPLAY_FILE_VERSION (3)
+/// Ticks between full state keyframes, bounds how far a seek resimulates.
+#define REPLAY_KEYFRAME_INTERVAL (300)
+/// Ticks skipped by seek keys during playback.
+#define REPLAY_SEEK_TICKS (60 * 5)
+
+/// Input for one simulation tick and the state hash after it ran.
+struct ReplayFrame {
+    struct Input input;
+    u64          hash;
+};
+/// State before tick ran.
+struct ReplayKeyframe {
+    u32 tick;
+    struct GameSnapshot snapshot;
+};
+
+struct Replay {
+    u32 level;
+    f32 tick_dt;
+
+    struct ReplayFrame* frames;
+    u32 frame_count;
+    u32 frame_capacity;
+
+    // NOTE(alicia): keyframe i is always at tick i * REPLAY_KEYFRAME_INTERVAL.
+    struct ReplayKeyframe* keyframes;
+    u32 keyframe_count;
+    u32 keyframe_capacity;
+};
+
+void replay_begin( struct Replay* out_replay, u32 level, f32 tick_dt );
+/// Call before every recorded tick, takes a keyframe when one is due.
+void replay_keyframe( struct Replay* replay, const struct SceneGame* state );
+void replay_push( struct Replay* replay, const struct Input* input, u64 hash );
+void replay_free( struct Replay* replay );
+/// Inputs are delta encoded into varints, keyframes are stored as is.
+b32  replay_save( const struct Replay* replay, const char* path );
+b32  replay_load( const char* path, struct Replay* out_replay );
+
+/// Restore closest keyframe at or before tick and fast forward to it.
+/// Keyframes don't hold rewind history, recordings that rewind
+/// past the seek point won't match their hashes after seeking.
+/// Tick is clamped to frame count. Returns tick state is now at,
+/// U32_MAX if replay has no keyframes or keyframe does not match
+/// loaded level, state is left untouched then.
+u32  replay_seek( const struct Replay* replay, struct SceneGame* state, u32 tick );
+
+#endif /* header guard */
@@ -0,0 +1,209 @@
+/**
+ * @file   rewind.c
+ * @brief  Rewind history of game simulation state.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 19, 2026
+*/
+#include "rewind.h"
+#include "sc_game.h"
+// IWYU pragma: begin_keep
+#include <string.h>
+// IWYU pragma: end_keep
+
+/// Zero runs shorter than this stay inside literal runs.
+#define REWIND_MIN_ZERO_RUN (4)
+
+b32 rewind_create( struct Rewind* out_rewind ) {
+    memset( out_rewind, 0, sizeof(*out_rewind) );
+    out_rewind->ring    = MemAlloc( REWIND_BUFFER_SIZE );
+    out_rewind->entries = MemAlloc( sizeof(struct RewindEntry) * REWIND_HISTORY_TICKS );
+    return out_rewind->ring && out_rewind->entries;
+}
+void rewind_destroy( struct Rewind* rewind ) {
+    MemFree( rewind->ring );
+    MemFree( rewind->entries );
+    MemFree( rewind->state );
+    MemFree( rewind->scratch );
+    MemFree( rewind->delta );
+    memset( rewind, 0, sizeof(*rewind) );
+}
+void rewind_clear( struct Rewind* rewind ) {
+    rewind->write_at    = 0;
+    rewind->entry_first = 0;
+    rewind->entry_count = 0;
+    rewind->bytes_used  = 0;
+    rewind->state_size  = 0;
+}
+
+static u8* rewind_write_varint( u8* at, u32 value ) {
+    do {
+        u8 byte = value & 0x7F;
+        value >>= 7;
+        *at++ = byte | ( value ? 0x80 : 0 );
+    } while( value );
+    return at;
+}
+static const u8* rewind_read_varint( const u8* at, u32* out_value ) {
+    u32 value = 0;
+    u32 shift = 0;
+    u8  byte;
+    do {
+        byte   = *at++;
+        value |= (u32)( byte & 0x7F ) << shift;
+        shift += 7;
+    } while( byte & 0x80 );
+    *out_value = value;
+    return at;
+}
+
+/// Encode a ^ b as (zero run, literal run, literals) triples.
+static usize rewind_delta_encode( const u8* a, const u8* b, usize size, u8* out ) {
+    u8* at = out;
+    usize i = 0;
+    while( i < size ) {
+        usize zero_start = i;
+        while( i < size && a[i] == b[i] ) {
+            i++;
+        }
+        u32 zeros = (u32)( i - zero_start );
+        if( i == size ) {
+            break;
+        }
+
+        usize literal_start = i;
+        usize zero_run      = 0;
+        while( i < size && zero_run < REWIND_MIN_ZERO_RUN ) {
+            zero_run = a[i] == b[i] ? zero_run + 1 : 0;
+            i++;
+        }
+        // NOTE(alicia): leave trailing zeros for next zero run.
+        i -= zero_run;
+        u32 literals = (u32)( i - literal_start );
+
+        at = rewind_write_varint( at, zeros );
+        at = rewind_write_varint( at, literals );
+        for( usize j = literal_start; j < i; ++j ) {
+            *at++ = a[j] ^ b[j];
+        }
+    }
+    return (usize)( at - out );
+}
+static void rewind_delta_apply( u8* state, const u8* delta, usize delta_size ) {
+    const u8* at  = delta;
+    const u8* end = delta + delta_size;
+    u8* dst = state;
+    while( at < end ) {
+        u32 zeros, literals;
+        at   = rewind_read_varint( at, &zeros );
+        at   = rewind_read_varint( at, &literals );
+        dst += zeros;
+        for( u32 i = 0; i < literals; ++i ) {
+            *dst++ ^= *at++;
+        }
+    }
+}
+
+static void rewind_drop_oldest( struct Rewind* rewind ) {
+    struct RewindEntry* oldest = rewind->entries + rewind->entry_first;
+    rewind->bytes_used -= oldest->size;
+    rewind->entry_first = ( rewind->entry_first + 1 ) % REWIND_HISTORY_TICKS;
+    rewind->entry_count--;
+}
+
+void rewind_record( struct Rewind* rewind, const struct SceneGame* state ) {
+    if( !rewind->ring ) {
+        return;
+    }
+
+    struct GameSnapshot snapshot;
+    snapshot.data     = rewind->scratch;
+    snapshot.size     = 0;
+    snapshot.capacity = rewind->scratch_capacity;
+    scene_game_snapshot_take( state, &snapshot );
+    rewind->scratch          = snapshot.data;
+    rewind->scratch_capacity = snapshot.capacity;
+
+    if( rewind->state_size != snapshot.size ) {
+        rewind_clear( rewind );
+    } else {
+        // NOTE(alicia): worst case is one literal byte per
+        // zero run, each preceded by two varints.
+        usize bound = snapshot.size * 3 + 16;
+        if( bound > rewind->delta_capacity ) {
+            rewind->delta          = MemRealloc( rewind->delta, bound );
+            rewind->delta_capacity = bound;
+        }
+        usize size = rewind_delta_encode(
+            rewind->state, snapshot.data, snapshot.size, rewind->delta );
+
+        if( size <= REWIND_BUFFER_SIZE ) {
+            if( rewind->write_at + size > REWIND_BUFFER_SIZE ) {
+                // NOTE(alicia): anything past write head is older than
+                // what was written since last wrap, drop it before wrapping.
+                while(
+                    rewind->entry_count &&
+                    rewind->entries[rewind->entry_first].offset >= rewind->write_at
+                ) {
+                    rewind_drop_oldest( rewind );
+                }
+                rewind->write_at = 0;
+            }
+            usize write_end = rewind->write_at + size;
+
+            // NOTE(alicia): entries are laid out in ring order so only
+            // the oldest can overlap the range about to be written.
+            while( rewind->entry_count ) {
+                struct RewindEntry* oldest = rewind->entries + rewind->entry_first;
+                // NOTE(alicia): ticks that changed nothing have empty
+                // deltas, they still occupy their offset for this test.
+                usize oldest_end = oldest->offset + ( oldest->size ? oldest->size : 1 );
+                b32 overlaps =
+                    oldest->offset < write_end && rewind->write_at < oldest_end;
+                if( !overlaps && rewind->entry_count < REWIND_HISTORY_TICKS ) {
+                    break;
+                }
+                rewind_drop_oldest( rewind );
+            }
+
+            u32 index = ( rewind->entry_first + rewind->entry_count ) % REWIND_HISTORY_TICKS;
+            rewind->entries[index].offset = (u32)rewind->write_at;
+            rewind->entries[index].size   = (u32)size;
+            rewind->entry_count++;
+            rewind->bytes_used += size;
+
+            memcpy( rewind->ring + rewind->write_at, rewind->delta, size );
+            rewind->write_at = write_end;
+        } else {
+            rewind_clear( rewind );
+        }
+    }
+
+    // NOTE(alicia): newest state and scratch swap roles,
+    // nothing is copied.
+    u8*   last          = rewind->state;
+    usize last_capacity = rewind->state_capacity;
+    rewind->state            = rewind->scratch;
+    rewind->state_size       = snapshot.size;
+    rewind->state_capacity   = rewind->scratch_capacity;
+    rewind->scratch          = last;
+    rewind->scratch_capacity = last_capacity;
+}
+b32 rewind_step( struct Rewind* rewind, struct SceneGame* state ) {
+    if( !rewind->entry_count ) {
+        return false;
+    }
+
+    u32 index = ( rewind->entry_first + rewind->entry_count - 1 ) % REWIND_HISTORY_TICKS;
+    struct RewindEntry* newest = rewind->entries + index;
+    rewind_delta_apply( rewind->state, rewind->ring + newest->offset, newest->size );
+
+    rewind->bytes_used -= newest->size;
+    rewind->write_at    = newest->offset;
+    rewind->entry_count--;
+
+    struct GameSnapshot snapshot;
+    snapshot.data     = rewind->state;
+    snapshot.size     = rewind->state_size;
+    snapshot.capacity = rewind->state_capacity;
+    return scene_game_snapshot_restore( state, &snapshot );
+}
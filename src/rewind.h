@@ -0,0 +1,56 @@
+#if !defined(REWIND_H)
+#define REWIND_H
+/**
+ * @file   rewind.h
+ * @brief  Rewind history of game simulation state.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 19, 2026
+*/
+#include "common.h"
+
+/// Ticks of history kept, 20 seconds at SIM_TICK_DT (60Hz).
+#define REWIND_HISTORY_TICKS (1200)
+/// Bytes of compressed deltas kept, oldest ticks are dropped first.
+#define REWIND_BUFFER_SIZE (2 * 1024 * 1024)
+
+struct SceneGame;
+
+struct RewindEntry {
+    u32 offset;
+    u32 size;
+};
+
+/// Newest full state plus ring buffer of run length encoded
+/// XOR deltas that each step one tick further back.
+struct Rewind {
+    u8*   ring;
+    usize write_at;
+
+    struct RewindEntry* entries;
+    u32 entry_first;
+    u32 entry_count;
+    usize bytes_used;
+
+    // NOTE(alicia): state after newest recorded tick,
+    // same layout as a GameSnapshot buffer.
+    u8*   state;
+    usize state_size;
+    usize state_capacity;
+
+    u8*   scratch;
+    usize scratch_capacity;
+    u8*   delta;
+    usize delta_capacity;
+};
+
+/// Rewind without buffers (zeroed) ignores record and step.
+b32  rewind_create( struct Rewind* out_rewind );
+void rewind_destroy( struct Rewind* rewind );
+void rewind_clear( struct Rewind* rewind );
+/// Push delta between last recorded state and current state.
+/// Clears history if snapshot size changed (actors spawned, level reloaded).
+void rewind_record( struct Rewind* rewind, const struct SceneGame* state );
+/// Restore state one recorded tick back. Returns false if history is empty.
+b32  rewind_step( struct Rewind* rewind, struct SceneGame* state );
+
+#endif /* header guard */
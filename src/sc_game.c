@@ -14,6 +14,7 @@
 #include "mathex.h"
 #include "physics.h"
 #include "debug.h"
+#include "job.h"
 // IWYU pragma: end_keep
 #include "json.h"
 #include "rlgl.h"
@@ -28,6 +29,9 @@ b32 string_cmp( struct json_string_s* a, struct json_string_s* b ) {
 void player_init( struct Player* out_player );
 void player_physics( struct Player* player, struct SceneGame* scene, f32 dt );
 void input_read( struct Input* out_input );
+void level_object_update_transform( struct LevelObject* obj );
+BoundingBox level_object_bounds( struct LevelObject* obj );
+BoundingBox model_local_bounds( Model model );
 
 struct json_object_element_s*
 find_item( struct json_object_s* object, const char* name ) {
@@ -68,6 +72,7 @@ b32 level_load( struct SceneGame* game, u32 level ) {
 
     struct json_object_s* root = json->payload;
     
+    game->level.stats        = &game->physics_stats;
     game->level.object_count = root->length;
     game->level.objects      =
         MemAlloc( sizeof(struct LevelObject) * game->level.object_count );
@@ -158,6 +163,35 @@ b32 level_load( struct SceneGame* game, u32 level ) {
                     }
                 }
 
+                if( lot->t_static.has_col && lot->t_static.col.meshCount ) {
+                    lot->collider = MemAlloc( sizeof(*lot->collider) );
+                    if( !collision_mesh_create(
+                        lot->t_static.col.meshes[0], lot->collider
+                    ) ) {
+                        MemFree( lot->collider );
+                        lot->collider = NULL;
+                    }
+                }
+
+                if( lot->collider ) {
+                    struct json_string_s* path = elem->value->payload;
+                    const char* sdf_path = collision_sdf_path( path->string );
+
+                    lot->t_static.sdf = MemAlloc( sizeof(*lot->t_static.sdf) );
+                    if( game->bake_sdf ) {
+                        TraceLog( LOG_INFO, "Baking SDF %s . . .", sdf_path );
+                        if(
+                            collision_sdf_bake( lot->collider, lot->t_static.sdf ) &&
+                            !collision_sdf_save( lot->t_static.sdf, sdf_path )
+                        ) {
+                            TraceLog( LOG_WARNING, "Failed to save SDF %s!", sdf_path );
+                        }
+                    } else if( !collision_sdf_load( sdf_path, lot->t_static.sdf ) ) {
+                        MemFree( lot->t_static.sdf );
+                        lot->t_static.sdf = NULL;
+                    }
+                }
+
                 f32 offset[3];
                 memset( offset, 0, sizeof(offset) );
                 elem = find_item( obj, "offset" );
@@ -185,6 +219,10 @@ b32 level_load( struct SceneGame* game, u32 level ) {
                 }
 
                 memcpy( &lot->t_static.offset, offset, sizeof(offset) );
+                if( lot->t_static.has_geo ) {
+                    lot->draw_local_bounds = model_local_bounds( lot->t_static.geo );
+                }
+                level_object_update_transform( lot );
 
             } break;
             case LOT_RESIZE: {
@@ -199,9 +237,11 @@ b32 level_load( struct SceneGame* game, u32 level ) {
                     if( strcmp( "p1", path->string ) == 0 ) {
                         lot->t_resize.geo = game->platform1;
                         lot->t_resize.geo_from_state = true;
+                        lot->t_resize.geo_batch      = 0;
                     } else if( strcmp( "p2", path->string ) == 0 ) {
                         lot->t_resize.geo = game->platform2;
                         lot->t_resize.geo_from_state = true;
+                        lot->t_resize.geo_batch      = 1;
                     } else {
                         lot->t_resize.geo = LoadModel( path->string );
                     }
@@ -214,11 +254,25 @@ b32 level_load( struct SceneGame* game, u32 level ) {
                     if( strcmp( "p1", path->string ) == 0 ) {
                         lot->t_resize.col = game->platform1;
                         lot->t_resize.col_from_state = true;
+
+                        lot->collider            = &game->platform1_collider;
+                        lot->collider_from_state = true;
                     } else if( strcmp( "p2", path->string ) == 0 ) {
                         lot->t_resize.col = game->platform2;
                         lot->t_resize.col_from_state = true;
+
+                        lot->collider            = &game->platform2_collider;
+                        lot->collider_from_state = true;
                     } else {
                         lot->t_resize.col = LoadModel( path->string );
+
+                        lot->collider = MemAlloc( sizeof(*lot->collider) );
+                        if( !collision_mesh_create(
+                            lot->t_resize.col.meshes[0], lot->collider
+                        ) ) {
+                            MemFree( lot->collider );
+                            lot->collider = NULL;
+                        }
                     }
                 }
 
@@ -306,14 +360,8 @@ b32 level_load( struct SceneGame* game, u32 level ) {
                 memcpy( &lot->t_resize.size_end, size_end, sizeof(size_end) );
 
                 lot->t_resize.size = lot->t_resize.size_start;
-                Matrix mat =
-                    MatrixTranslate(
-                        lot->t_resize.offset.x, lot->t_resize.offset.y, lot->t_resize.offset.z );
-                mat = MatrixMultiply(
-                    MatrixScale( lot->t_resize.size.x, lot->t_resize.size.y, lot->t_resize.size.z ),
-                    mat );
-                lot->t_resize.geo.transform = mat;
-                lot->t_resize.col.transform = mat;
+                lot->draw_local_bounds = model_local_bounds( lot->t_resize.geo );
+                level_object_update_transform( lot );
             } break;
         }
         current = current->next;
@@ -321,18 +369,107 @@ b32 level_load( struct SceneGame* game, u32 level ) {
 
     game->level.object_count = lot_i;
 
+    BoundingBox* bounds  = MemAlloc( sizeof(BoundingBox) * lot_i );
+    b32*         enabled = MemAlloc( sizeof(b32) * lot_i );
+    for( u32 i = 0; i < lot_i; ++i ) {
+        struct LevelObject* obj = game->level.objects + i;
+        if( obj->collider ) {
+            bounds[i]  = level_object_bounds( obj );
+            enabled[i] = true;
+        }
+    }
+    level_bvh_create( &game->level.bvh, bounds, enabled, lot_i );
+    MemFree( enabled );
+    MemFree( bounds );
+
+    Model*  static_models     = MemAlloc( sizeof(Model)  * lot_i );
+    Matrix* static_transforms = MemAlloc( sizeof(Matrix) * lot_i );
+    u32     static_count      = 0;
+    for( u32 i = 0; i < lot_i; ++i ) {
+        struct LevelObject* obj = game->level.objects + i;
+        if( obj->type == LOT_STATIC && obj->t_static.has_geo ) {
+            static_models[static_count]     = obj->t_static.geo;
+            static_transforms[static_count] = MatrixMultiply(
+                obj->t_static.geo.transform, obj->collider_transform );
+            static_count++;
+        }
+    }
+    static_geometry_build(
+        &game->level.static_geo, static_models, static_transforms, static_count );
+    MemFree( static_transforms );
+    MemFree( static_models );
+
+    capsule_cache_invalidate( &game->capsule_cache );
+    collision_cache_invalidate( &game->ground_cache );
+
+    actor_pool_clear( &game->actors );
+    game->player_actor = actor_spawn(
+        &game->actors, ACTOR_KINEMATIC, v3_zero(),
+        PLAYER_CAPSULE_RADIUS, PLAYER_CAPSULE_HEIGHT );
+
     StopMusicStream( game->music_game_over );
     PlayMusicStream( game->music );
 
     free(json);
     return true;
 }
+void level_object_update_transform( struct LevelObject* obj ) {
+    Matrix mat      = MatrixIdentity();
+    Matrix draw_mat = MatrixIdentity();
+    switch( obj->type ) {
+        case LOT_NULL: break;
+        case LOT_STATIC: {
+            mat = MatrixTranslate(
+                obj->t_static.offset.x,
+                obj->t_static.offset.y,
+                obj->t_static.offset.z );
+            // NOTE(alicia): DrawModel applies model transform before position.
+            draw_mat = MatrixMultiply( obj->t_static.geo.transform, mat );
+        } break;
+        case LOT_RESIZE: {
+            struct LevelObjectResize* resize = &obj->t_resize;
+            mat = MatrixTranslate(
+                resize->offset.x, resize->offset.y, resize->offset.z );
+            mat = MatrixMultiply(
+                MatrixScale( resize->size.x, resize->size.y, resize->size.z ),
+                mat );
+            // NOTE(alicia): geo and col models are drawn while ticks run,
+            // their transforms are left alone, draw takes this matrix
+            // from draw snapshot instead.
+            draw_mat = mat;
+        } break;
+    }
+
+    obj->collider_transform = mat;
+    obj->collider_inverse   = MatrixInvert( mat );
+    obj->draw_bounds        = bounds_transform( obj->draw_local_bounds, draw_mat );
+}
+BoundingBox model_local_bounds( Model model ) {
+    BoundingBox result = {0};
+    for( int i = 0; i < model.meshCount; ++i ) {
+        BoundingBox mesh_bounds = GetMeshBoundingBox( model.meshes[i] );
+        result = i ? bounds_merge( result, mesh_bounds ) : mesh_bounds;
+    }
+    return result;
+}
+BoundingBox level_object_bounds( struct LevelObject* obj ) {
+    return bounds_transform(
+        collision_mesh_bounds( obj->collider ), obj->collider_transform );
+}
 void level_unload( struct SceneGame* game, struct Level* level ) {
     for( usize i = 0; i < level->object_count; ++i ) {
         struct LevelObject* obj = level->objects + i;
+        if( obj->collider && !obj->collider_from_state ) {
+            collision_mesh_destroy( obj->collider );
+            MemFree( obj->collider );
+        }
         switch( obj->type ) {
             case LOT_NULL: break;
             case LOT_STATIC: {
+                if( obj->t_static.sdf ) {
+                    collision_sdf_destroy( obj->t_static.sdf );
+                    MemFree( obj->t_static.sdf );
+                }
                 if( obj->t_static.has_geo ) {
                     UnloadModel( obj->t_static.geo );
                 }
@@ -352,6 +489,8 @@ void level_unload( struct SceneGame* game, struct Level* level ) {
     }
 
     MemFree( level->objects );
+    level_bvh_destroy( &level->bvh );
+    static_geometry_destroy( &level->static_geo );
     memset( level, 0, sizeof(*level) );
 
     StopMusicStream( game->music );
@@ -368,6 +507,14 @@ void scene_game_load( struct SceneGame* out_state ) {
 
     out_state->platform1 = LoadModel( "resources/mesh/level/platform01.glb");
     out_state->platform2 = LoadModel( "resources/mesh/level/platform02.glb");
+    collision_mesh_create(
+        out_state->platform1.meshes[0], &out_state->platform1_collider );
+    collision_mesh_create(
+        out_state->platform2.meshes[0], &out_state->platform2_collider );
+    instance_batch_create( out_state->platform_batches + 0, out_state->platform1 );
+    instance_batch_create( out_state->platform_batches + 1, out_state->platform2 );
+    render_instanced_shader_load( &out_state->shader_instanced );
+    actor_pool_create( &out_state->actors, ACTOR_CAPACITY );
 
     level_load( out_state, 0 );
     player_init( &out_state->player );
@@ -402,19 +549,71 @@ void scene_game_load( struct SceneGame* out_state ) {
     out_state->tx_player_mouth = mouth;
 
     out_state->model_player = player;
-
-    out_state->player_anim = LoadModelAnimations(
-        "resources/mesh/player.iqm", &out_state->player_anim_count );
+    skin_model_create( player, &out_state->player_skin );
+
+    // NOTE(alicia): only compressed clips are kept, raylib's
+    // full precision poses are dropped as soon as they're packed.
+    int anim_count = 0;
+    ModelAnimation* anims =
+        LoadModelAnimations( "resources/mesh/player.iqm", &anim_count );
+    usize raw_memory = 0;
+    usize clip_memory = 0;
+    out_state->player_clip_count = anim_count > 0 ? (u32)anim_count : 0;
+    out_state->player_clips =
+        MemAlloc( sizeof(struct AnimClip) * ( out_state->player_clip_count + 1 ) );
+    for( u32 i = 0; i < out_state->player_clip_count; ++i ) {
+        anim_clip_compress( anims[i], out_state->player_clips + i );
+        raw_memory  += anim_raw_memory( anims[i] );
+        clip_memory += anim_clip_memory( out_state->player_clips + i );
+    }
+    UnloadModelAnimations( anims, anim_count );
+    TraceLog( LOG_INFO, "Player clips: %u, %.2fKiB packed (%.2fKiB unpacked)",
+        out_state->player_clip_count, clip_memory / 1024.0f, raw_memory / 1024.0f );
 
     out_state->current_animation = PLAYER_IDLE;
+    anim_sampler_create( (u32)player.boneCount, &out_state->player_sampler );
+
+    // NOTE(alicia): frame cache is baked the first time it's needed.
+    memset( &out_state->player_cache, 0, sizeof(out_state->player_cache) );
+    out_state->player_cache.last_frame = U32_MAX;
+    out_state->player_cache_baked      = false;
 
+    dynamic_resolution_create(
+        &out_state->resolution, GetScreenWidth(), GetScreenHeight() );
+
+    out_state->gpu_skinning = skin_gpu_create(
+        &out_state->player_skin, player, &out_state->player_gpu_skin );
+    TraceLog( LOG_INFO, "Player skinning: %s",
+        out_state->gpu_skinning ? "GPU" : "CPU" );
+
+    scene_game_snapshot_take( out_state, &out_state->checkpoint );
+    rewind_create( &out_state->rewind );
+    scene_game_draw_snapshot_write( out_state, scene_game_draw_front( out_state ) );
 }
 void scene_game_unload( struct SceneGame* state ) {
     level_unload( state, &state->level );
     UnloadModel( state->platform1 );
     UnloadModel( state->platform2 );
+    collision_mesh_destroy( &state->platform1_collider );
+    collision_mesh_destroy( &state->platform2_collider );
+    instance_batch_destroy( state->platform_batches + 0 );
+    instance_batch_destroy( state->platform_batches + 1 );
+    if( render_instanced_shader_valid( state->shader_instanced ) ) {
+        UnloadShader( state->shader_instanced );
+    }
+    actor_pool_destroy( &state->actors );
+    anim_sampler_destroy( &state->player_sampler );
+    dynamic_resolution_destroy( &state->resolution );
+    scene_game_draw_snapshot_free( state->draw_snapshots + 0 );
+    scene_game_draw_snapshot_free( state->draw_snapshots + 1 );
+    skin_cache_destroy( &state->player_cache );
+    skin_gpu_destroy( &state->player_gpu_skin, state->model_player );
+    skin_model_destroy( &state->player_skin );
     UnloadModel( state->model_player );
-    UnloadModelAnimations( state->player_anim, state->player_anim_count );
+    for( u32 i = 0; i < state->player_clip_count; ++i ) {
+        anim_clip_destroy( state->player_clips + i );
+    }
+    MemFree( state->player_clips );
     UnloadTexture( state->tx_player_main  );
     UnloadTexture( state->tx_player_hair  );
     UnloadTexture( state->tx_player_eyes  );
@@ -423,39 +622,269 @@ void scene_game_unload( struct SceneGame* state ) {
     UnloadMusicStream( state->music_game_over );
     UnloadSound( state->sfx_jump );
     UnloadSound( state->sfx_resize );
+    scene_game_snapshot_free( &state->checkpoint );
+    rewind_destroy( &state->rewind );
 
     memset( state, 0, sizeof(*state) );
 }
-void scene_game_update( f32 dt, struct SceneGame* state ) {
-    unused(dt, state);
+void scene_game_instance_create(
+    const struct SceneGame* source, struct SceneGame* out_instance
+) {
+    memcpy( out_instance, source, sizeof(*out_instance) );
+
+    // NOTE(alicia): resize objects and BVH bounds are written to every
+    // tick, everything they point at (models, colliders, SDFs) is not.
+    struct Level* level = &out_instance->level;
+    level->objects = MemAlloc( sizeof(struct LevelObject) * level->object_count );
+    memcpy(
+        level->objects, source->level.objects,
+        sizeof(struct LevelObject) * level->object_count );
+    level_bvh_clone( &source->level.bvh, &level->bvh );
+    level->stats = &out_instance->physics_stats;
+    physics_stats_reset( level->stats );
+
+    actor_pool_create( &out_instance->actors, source->actors.capacity );
+    for( u32 i = 0; i < source->actors.count; ++i ) {
+        u32 actor = actor_spawn(
+            &out_instance->actors, (enum ActorKind)source->actors.kind[i],
+            actor_position( &source->actors, i ),
+            source->actors.radius[i], source->actors.height[i] );
+        actor_set_velocity(
+            &out_instance->actors, actor, actor_velocity( &source->actors, i ) );
+        out_instance->actors.flags[actor] = source->actors.flags[i];
+    }
 
-    struct Player* player = &state->player;
+    capsule_cache_invalidate( &out_instance->capsule_cache );
+    collision_cache_invalidate( &out_instance->ground_cache );
 
+    // NOTE(alicia): checkpoint buffer is shared with source,
+    // restoring only reads from it. rewind history is not,
+    // instances start without one.
+    memset( &out_instance->rewind, 0, sizeof(out_instance->rewind) );
+    // NOTE(alicia): instances are never drawn.
+    memset( out_instance->draw_snapshots, 0, sizeof(out_instance->draw_snapshots) );
+}
+void scene_game_instance_destroy( struct SceneGame* instance ) {
+    MemFree( instance->level.objects );
+    level_bvh_destroy( &instance->level.bvh );
+    actor_pool_destroy( &instance->actors );
+    rewind_destroy( &instance->rewind );
+    memset( instance, 0, sizeof(*instance) );
+}
+void scene_game_poll( struct SceneGame* state, struct Input* out_input ) {
+    unused( state );
     if( IsMouseButtonPressed( MOUSE_BUTTON_LEFT ) ) {
         DisableCursor();
     }
-    if( player->is_dead ) {
-        memset( &player->input, 0, sizeof(player->input) );
-    } else {
-        input_read( &player->input );
-    }
+    input_read( out_input );
+}
+void scene_game_update( f32 dt, struct SceneGame* state, struct Input* out_input ) {
+    unused( dt );
+    scene_game_poll( state, out_input );
 
 #if defined(DEBUG)
     {
+        struct Player* player = &state->player;
         b32 f5 = IsKeyPressed( KEY_F5 );
         b32 r  = IsKeyPressed( KEY_R );
+        b32 f7 = IsKeyPressed( KEY_F7 );
+
+        if( f5 ) {
+            level_unload( state, &state->level );
+            level_load( state, 0 );
+            player_init( player );
+            scene_game_snapshot_take( state, &state->checkpoint );
+        } else if( r ) {
+            scene_game_snapshot_restore( state, &state->checkpoint );
+        }
+
+        if( IsKeyPressed( KEY_F6 ) ) {
+            state->use_sdf = !state->use_sdf;
+            // NOTE(alicia): cached contacts came from other backend.
+            capsule_cache_invalidate( &state->capsule_cache );
+            collision_cache_invalidate( &state->ground_cache );
+            TraceLog( LOG_INFO, "Static collision backend: %s",
+                state->use_sdf ? "SDF" : "triangles" );
+        }
 
-        if( f5 || r ) {
-            if( f5 ) {
-                level_unload( state, &state->level );
-                level_load( state, 0 );
+        if( IsKeyPressed( KEY_F8 ) ) {
+            state->anim_cache_forced = !state->anim_cache_forced;
+            TraceLog( LOG_INFO, "Player frame cache forced: %s",
+                state->anim_cache_forced ? "on" : "off" );
+        }
+
+        if( IsKeyPressed( KEY_F10 ) && state->resolution.target.id ) {
+            state->resolution.enabled = !state->resolution.enabled;
+            TraceLog( LOG_INFO, "Dynamic resolution: %s",
+                state->resolution.enabled ? "on" : "off" );
+        }
+
+        if( IsKeyPressed( KEY_F9 ) && state->player_gpu_skin.shader.id ) {
+            state->gpu_skinning = !state->gpu_skinning;
+            TraceLog( LOG_INFO, "Player skinning: %s",
+                state->gpu_skinning ? "GPU" : "CPU" );
+        }
+
+        if( f7 ) {
+            for( u32 i = 0; i < ACTOR_DEBUG_SPAWN_COUNT; ++i ) {
+                f32 angle = ( (f32)i / ACTOR_DEBUG_SPAWN_COUNT ) * 2.0f * PI;
+                f32 ring  = 1.0f + (f32)( i % 4 ) * 0.6f;
+                Vector3 position = Vector3Add(
+                    player->transform.translation,
+                    v3( cosf( angle ) * ring, 2.0f + (f32)( i % 3 ), sinf( angle ) * ring ) );
+                actor_spawn(
+                    &state->actors, i % 2 ? ACTOR_PROP : ACTOR_NPC, position,
+                    PLAYER_CAPSULE_RADIUS, PLAYER_CAPSULE_HEIGHT );
             }
+        }
 
-            player_init( player );
+        // NOTE(alicia): front snapshot may point at objects
+        // and actors that no longer exist.
+        if( f5 || r || f7 ) {
+            scene_game_draw_snapshot_write( state, scene_game_draw_front( state ) );
         }
     }
 #endif
+}
+void scene_game_animate( f32 dt, struct SceneGame* state ) {
+    if(
+        state->current_animation < 0 ||
+        (u32)state->current_animation >= state->player_clip_count
+    ) {
+        return;
+    }
+    struct AnimSampler* sampler = &state->player_sampler;
+    anim_sampler_play(
+        sampler, state->player_clips, state->current_animation, ANIM_CROSSFADE_TIME );
+    anim_sampler_update( sampler, state->player_clips, dt );
+}
+void scene_game_draw_snapshot_write(
+    const struct SceneGame* state, struct DrawSnapshot* out_snapshot
+) {
+    const struct Player* player = &state->player;
+    struct DrawSnapshot* snapshot = out_snapshot;
+
+    snapshot->camera            = state->camera;
+    snapshot->player_transform  = player->transform;
+    snapshot->player_velocity   = player->velocity;
+    snapshot->player_capsule    = player->capsule;
+    snapshot->player_hit        = player->level_collision.hit;
+    snapshot->player_dead       = player->is_dead;
+    snapshot->player_won        = player->won;
+#if defined(DEBUG)
+    memcpy( snapshot->player_ground, player->ground, sizeof(player->ground) );
+    snapshot->player_last_collision = player->last_level_collision;
+#endif
+
+    snapshot->resize_allowed_timer = state->resize_allowed_timer;
+    snapshot->dead_timer           = state->dead_timer;
+    snapshot->won_timer            = state->won_timer;
+
+    u32 object_count = (u32)state->level.object_count;
+    if( object_count > snapshot->object_capacity ) {
+        snapshot->object_capacity   = object_count;
+        snapshot->object_transforms = MemRealloc(
+            snapshot->object_transforms, sizeof(Matrix) * object_count );
+        snapshot->object_bounds     = MemRealloc(
+            snapshot->object_bounds, sizeof(BoundingBox) * object_count );
+    }
+    snapshot->object_count = object_count;
+    for( u32 i = 0; i < object_count; ++i ) {
+        const struct LevelObject* obj = state->level.objects + i;
+        snapshot->object_transforms[i] = obj->collider_transform;
+        snapshot->object_bounds[i] = obj->draw_bounds;
+    }
+
+    const struct ActorPool* actors = &state->actors;
+    if( actors->count > snapshot->actor_capacity ) {
+        u32 capacity = actors->capacity;
+        snapshot->actor_capacity  = capacity;
+        snapshot->actor_positions = MemRealloc(
+            snapshot->actor_positions, sizeof(Vector3) * capacity );
+        snapshot->actor_radius = MemRealloc( snapshot->actor_radius, sizeof(f32) * capacity );
+        snapshot->actor_height = MemRealloc( snapshot->actor_height, sizeof(f32) * capacity );
+        snapshot->actor_kind   = MemRealloc( snapshot->actor_kind,   sizeof(u8)  * capacity );
+    }
+    snapshot->actor_count = actors->count;
+    for( u32 i = 0; i < actors->count; ++i ) {
+        snapshot->actor_positions[i] = actor_position( actors, i );
+    }
+    memcpy( snapshot->actor_radius, actors->radius, sizeof(f32) * actors->count );
+    memcpy( snapshot->actor_height, actors->height, sizeof(f32) * actors->count );
+    memcpy( snapshot->actor_kind,   actors->kind,   sizeof(u8)  * actors->count );
+    snapshot->player_actor        = state->player_actor;
+    snapshot->actor_pair_count    = actors->pair_count;
+    snapshot->actor_contact_count = actors->contact_count;
+
+    const struct AnimSampler* sampler = &state->player_sampler;
+    snapshot->skinned_count = 0;
+    snapshot->animation     = -1;
+    if(
+        state->current_animation >= 0 &&
+        (u32)state->current_animation < state->player_clip_count &&
+        sampler->bone_count
+    ) {
+        if( !snapshot->pose ) {
+            snapshot->pose = MemAlloc( sizeof(Transform) * sampler->bone_count );
+        }
+        snapshot->bone_count = sampler->bone_count;
+        memcpy( snapshot->pose, sampler->pose, sizeof(Transform) * sampler->bone_count );
+        snapshot->skinned_count   = 1;
+        snapshot->animation       = state->current_animation;
+        snapshot->animation_frame = anim_sampler_frame( sampler, state->player_clips );
+    }
 
+    snapshot->capsule_cache_hit_rate =
+        cache_counters_hit_rate( &state->capsule_cache_counters );
+    snapshot->ground_cache_hit_rate  =
+        cache_counters_hit_rate( &state->ground_cache_counters );
+    snapshot->bvh_node_count    = state->level.bvh.node_count;
+    snapshot->bvh_cost_ratio    = state->level.bvh.build_cost ?
+        state->level.bvh.cost / state->level.bvh.build_cost : 0.0f;
+    snapshot->bvh_refit_count   = state->level.bvh.refit_count;
+    snapshot->bvh_rebuild_count = state->level.bvh.rebuild_count;
+    snapshot->rewind_entry_count = state->rewind.entry_count;
+    snapshot->rewind_bytes_used  = state->rewind.bytes_used;
+    snapshot->physics_counters   = state->physics_counters;
+}
+void scene_game_draw_snapshot_free( struct DrawSnapshot* snapshot ) {
+    MemFree( snapshot->object_transforms );
+    MemFree( snapshot->object_bounds );
+    MemFree( snapshot->actor_positions );
+    MemFree( snapshot->actor_radius );
+    MemFree( snapshot->actor_height );
+    MemFree( snapshot->actor_kind );
+    MemFree( snapshot->pose );
+    memset( snapshot, 0, sizeof(*snapshot) );
+}
+struct DrawSnapshot* scene_game_draw_front( struct SceneGame* state ) {
+    return state->draw_snapshots + state->draw_front;
+}
+struct DrawSnapshot* scene_game_draw_back( struct SceneGame* state ) {
+    return state->draw_snapshots + ( state->draw_front ^ 1 );
+}
+static u32 scene_game_simulate(
+    f32 dt, struct SceneGame* state, const struct Input* input );
+u32 scene_game_tick( f32 dt, struct SceneGame* state, const struct Input* input ) {
+    if( input->rewind_hold ) {
+        return rewind_step( &state->rewind, state ) ? GAME_EVENT_REWIND : 0;
+    }
+
+    u32 events = scene_game_simulate( dt, state, input );
+    rewind_record( &state->rewind, state );
+    return events;
+}
+static u32 scene_game_simulate(
+    f32 dt, struct SceneGame* state, const struct Input* input
+) {
+    struct Player* player = &state->player;
+    u32 events = 0;
+
+    if( player->is_dead ) {
+        memset( &player->input, 0, sizeof(player->input) );
+    } else {
+        player->input = *input;
+    }
 
     player->camera_rotation.x += 0.2f * ( player->input.rotation.x * dt );
     player->camera_rotation.y += 0.2f * ( -player->input.rotation.y * dt );
@@ -532,7 +961,7 @@ void scene_game_update( f32 dt, struct SceneGame* state ) {
             Vector3 jump_vector = Vector3Multiply( jump_direction, jump_magnitude );
             player_move = Vector3Add( player_move, jump_vector );
 
-            PlaySound( state->sfx_jump );
+            events |= GAME_EVENT_JUMP;
         }
     } else {
         player_move = Vector3Multiply( player_move, v3_scalar( 0.1f ) );
@@ -572,7 +1001,7 @@ void scene_game_update( f32 dt, struct SceneGame* state ) {
         state->resize_timer   = RESIZE_TIME;
         state->resize_reverse = !state->resize_reverse;
 
-        PlaySound( state->sfx_resize );
+        events |= GAME_EVENT_RESIZE;
     }
     state->last_resize_enabled = state->resize_enabled;
 
@@ -597,16 +1026,16 @@ void scene_game_update( f32 dt, struct SceneGame* state ) {
             struct LevelObjectResize* resize = &obj->t_resize;
 
             resize->size = v3_lerp( resize->size_start, resize->size_end, t );
-
-            Matrix mat =
-                MatrixTranslate(
-                    resize->offset.x, resize->offset.y, resize->offset.z );
-            mat = MatrixMultiply(
-                MatrixScale( resize->size.x, resize->size.y, resize->size.z ),
-                mat );
-            resize->geo.transform = mat;
-            resize->col.transform = mat;
+            level_object_update_transform( obj );
+            if( obj->collider ) {
+                level_bvh_set_bounds(
+                    &state->level.bvh, i, level_object_bounds( obj ) );
+            }
         }
+        level_bvh_refit( &state->level.bvh );
+        // NOTE(alicia): cached triangles may have moved or
+        // been reordered by a rebuild.
+        capsule_cache_invalidate( &state->capsule_cache );
     }
 
     Vector2 velocity_2d = v2( player->velocity.x, player->velocity.z );
@@ -623,30 +1052,28 @@ void scene_game_update( f32 dt, struct SceneGame* state ) {
 
     player_physics( player, state, dt );
 
+    if( state->player_actor < state->actors.count ) {
+        actor_set_position(
+            &state->actors, state->player_actor, player->transform.translation );
+        actor_set_velocity( &state->actors, state->player_actor, player->velocity );
+    }
+    level_actors_step( &state->level, &state->actors, state->use_sdf, dt );
+
     if( !player->won && player->transform.translation.y < KILL_PLANE ) {
         player->is_dead = true;
     }
 
     if( state->last_dead != player->is_dead ) {
         state->dead_timer = 0.0f;
-        StopMusicStream( state->music );
-        PlayMusicStream( state->music_game_over );
+        events |= GAME_EVENT_DIED;
     }
 
     if( player->is_dead ) {
         state->dead_timer += dt;
         if( state->dead_timer >= DEAD_TIME + (DEAD_TIME / 2.0f) ) {
-            scene_load( SC_TITLE );
+            scene_game_snapshot_restore( state, &state->checkpoint );
+            return events | GAME_EVENT_RESPAWN;
         }
-        UpdateMusicStream( state->music_game_over );
-    } else {
-        f32 music_len = GetMusicTimeLength( state->music );
-        f32 played    = GetMusicTimePlayed( state->music );
-        if( played >= music_len - 1.2f ) {
-            StopMusicStream( state->music );
-            PlayMusicStream( state->music );
-        }
-        UpdateMusicStream( state->music );
     }
 
     state->last_dead = player->is_dead;
@@ -662,44 +1089,165 @@ void scene_game_update( f32 dt, struct SceneGame* state ) {
     if( player->won ) {
         state->won_timer += dt;
         if( state->won_timer > DEAD_TIME + (DEAD_TIME / 2.0f) ) {
-            scene_load( SC_TITLE );
+            events |= GAME_EVENT_EXIT;
+        }
+    }
+
+    return events;
+}
+void scene_game_events( struct SceneGame* state, u32 events ) {
+    if( events & GAME_EVENT_JUMP ) {
+        PlaySound( state->sfx_jump );
+    }
+    if( events & GAME_EVENT_RESIZE ) {
+        PlaySound( state->sfx_resize );
+    }
+    if( events & GAME_EVENT_DIED ) {
+        StopMusicStream( state->music );
+        PlayMusicStream( state->music_game_over );
+    }
+    if(
+        ( events & GAME_EVENT_RESPAWN ) ||
+        ( ( events & GAME_EVENT_REWIND ) && !state->player.is_dead &&
+            IsMusicStreamPlaying( state->music_game_over ) )
+    ) {
+        StopMusicStream( state->music_game_over );
+        PlayMusicStream( state->music );
+    }
+
+    if( state->player.is_dead ) {
+        UpdateMusicStream( state->music_game_over );
+    } else {
+        f32 music_len = GetMusicTimeLength( state->music );
+        f32 played    = GetMusicTimePlayed( state->music );
+        if( played >= music_len - 1.2f ) {
+            StopMusicStream( state->music );
+            PlayMusicStream( state->music );
         }
+        UpdateMusicStream( state->music );
+    }
+
+    if( events & GAME_EVENT_EXIT ) {
+        scene_load( SC_TITLE );
+    }
+}
+static void scene_game_bake_player_cache( struct SceneGame* state ) {
+    state->player_cache_baked = true;
+    if( skin_cache_bake(
+        &state->player_skin, state->model_player,
+        state->player_clips, state->player_clip_count,
+        &state->player_cache
+    ) ) {
+        TraceLog( LOG_INFO, "Player frame cache: %u frames, %.2fKiB (%.2fKiB as f32)",
+            state->player_cache.frame_count,
+            skin_cache_memory( &state->player_cache ) / 1024.0f,
+            skin_cache_raw_memory( &state->player_cache ) / 1024.0f );
+    }
+}
+static void scene_game_skin( struct SceneGame* state, const struct DrawSnapshot* snapshot ) {
+    if( snapshot->animation < 0 ) {
+        return;
+    }
+
+    // NOTE(alicia): GPU skinning costs the same with any number
+    // of actors, frame cache is only worth it when skinning on CPU.
+    b32 gpu_skinning = state->gpu_skinning && state->player_gpu_skin.shader.id;
+    b32 want_cache = !gpu_skinning && (
+        state->anim_cache_forced ||
+        snapshot->skinned_count >= ANIM_CACHE_SKINNED_THRESHOLD );
+    if( want_cache && !state->player_cache_baked ) {
+        scene_game_bake_player_cache( state );
+    }
+    state->anim_cache_active = want_cache && state->player_cache.frame_count;
+
+    if( gpu_skinning ) {
+        state->player_cache.last_frame = U32_MAX;
+        skin_gpu_enable( &state->player_gpu_skin, state->model_player );
+        skin_gpu_pose(
+            &state->player_gpu_skin, &state->player_skin,
+            state->model_player, snapshot->pose );
+        return;
+    }
+    skin_gpu_disable( &state->player_gpu_skin, state->model_player );
+
+    // NOTE(alicia): frame cache only has whole frames,
+    // it snaps between clips instead of crossfading.
+    if( state->anim_cache_active ) {
+        skin_cache_play(
+            &state->player_cache, state->model_player,
+            (u32)snapshot->animation, snapshot->animation_frame );
+    } else {
+        state->player_cache.last_frame = U32_MAX;
+        skin_model_pose( &state->player_skin, state->model_player, snapshot->pose );
     }
 }
 void scene_game_draw( f32 dt, struct SceneGame* state ) {
     unused(dt, state);
+    const struct DrawSnapshot* snapshot = scene_game_draw_front( state );
+    scene_game_skin( state, snapshot );
+
+    struct DynamicResolution* resolution = &state->resolution;
+    dynamic_resolution_resize( resolution, GetScreenWidth(), GetScreenHeight() );
+    dynamic_resolution_update( resolution, GetFrameTime() );
+    dynamic_resolution_begin( resolution );
+
     ClearBackground( (Color){ 102, 191, 255, 255 } );
 
-    struct Player* player = &state->player;
+    BeginMode3D( snapshot->camera );
 
-    BeginMode3D( state->camera );
+    struct Frustum frustum = frustum_from_matrix( camera_view_projection(
+        snapshot->camera, (f32)GetScreenWidth() / (f32)GetScreenHeight() ) );
+    state->draw_count      = 0;
+    state->cull_count      = 0;
+    state->draw_call_count = 0;
+    for( u32 i = 0; i < PLATFORM_BATCH_COUNT; ++i ) {
+        instance_batch_clear( state->platform_batches + i );
+    }
 
-    for( usize i = 0; i < state->level.object_count; ++i ) {
-        struct LevelObject* obj = state->level.objects + i;
-        switch( obj->type ) {
-            case LOT_NULL: continue;
-            case LOT_STATIC: {
-                if( obj->t_static.has_geo ) {
-                    DrawModel( obj->t_static.geo, obj->t_static.offset, 1.0f, WHITE );
-                }
-            } break;
-            case LOT_RESIZE: {
-                DrawModel( obj->t_resize.geo, v3_zero(), 1.0f, PURPLE );
-            } break;
+    const struct StaticGeometry* static_geo = &state->level.static_geo;
+    for( u32 i = 0; i < static_geo->chunk_count; ++i ) {
+        const struct StaticChunk* chunk = static_geo->chunks + i;
+        if( !frustum_overlaps_bounds( &frustum, chunk->bounds ) ) {
+            state->cull_count++;
+            continue;
         }
+        state->draw_count++;
+        DrawMesh( chunk->mesh, chunk->material, MatrixIdentity() );
+        state->draw_call_count++;
     }
 
-    state->anim_timer += dt;
-    if( state->anim_timer >= ANIM_FT ) {
-        state->anim_frame++;
-        UpdateModelAnimation( 
-            state->model_player, state->player_anim[state->current_animation], 
-            state->anim_frame % state->player_anim[state->current_animation].frameCount );
-        state->anim_timer = 0.0f;
+    // NOTE(alicia): static objects are drawn through static_geo.
+    // ticks never write resize models, their transforms come from snapshot.
+    for( u32 i = 0; i < snapshot->object_count; ++i ) {
+        const struct LevelObject* obj = state->level.objects + i;
+        if( obj->type != LOT_RESIZE ) {
+            continue;
+        }
+        if( !frustum_overlaps_bounds( &frustum, snapshot->object_bounds[i] ) ) {
+            state->cull_count++;
+            continue;
+        }
+        state->draw_count++;
+
+        if( obj->t_resize.geo_from_state ) {
+            instance_batch_push(
+                state->platform_batches + obj->t_resize.geo_batch,
+                snapshot->object_transforms[i] );
+        } else {
+            Model geo = obj->t_resize.geo;
+            geo.transform = snapshot->object_transforms[i];
+            DrawModel( geo, v3_zero(), 1.0f, PURPLE );
+            state->draw_call_count += obj->t_resize.geo.meshCount;
+        }
+    }
+    for( u32 i = 0; i < PLATFORM_BATCH_COUNT; ++i ) {
+        state->draw_call_count += instance_batch_draw(
+            state->platform_batches + i, state->shader_instanced, PURPLE );
     }
 
+    const Transform* player_transform = &snapshot->player_transform;
     Vector3 player_forward =
-        Vector3RotateByQuaternion( v3_forward(), player->transform.rotation );
+        Vector3RotateByQuaternion( v3_forward(), player_transform->rotation );
 
     f32 angle = Vector3Angle(v3_forward(), player_forward);
     angle *= player_forward.x < 0.0f ? -1.0f : 1.0f;
@@ -716,62 +1264,62 @@ void scene_game_draw( f32 dt, struct SceneGame* state ) {
 
     state->model_player.transform = MatrixRotate( axis, angle );
 
-    DrawModel( state->model_player, player->transform.translation, 1.0f, WHITE );
+    DrawModel( state->model_player, player_transform->translation, 1.0f, WHITE );
     DrawSphere( state->level.level_finish, 1.0f, RED );
 
 #if defined(DEBUG)
     /*debug*/ {
 
         Vector3 forward_line_start = Vector3Add(
-            player->transform.translation, CAMERA_TARGET_OFFSET );
+            player_transform->translation, CAMERA_TARGET_OFFSET );
         Vector3 forward_line_end   = Vector3Add( forward_line_start, player_forward );
         DrawLine3D( forward_line_start, forward_line_end, BLUE );
 
         Vector3 ground_check_start, ground_check_end;
 
         ground_check_start = Vector3Add( 
-            player->transform.translation, Vector3Add( Vector3Multiply( v3_forward(), v3_scalar(PLAYER_CAPSULE_RADIUS) ), PLAYER_GROUND_CHECK_OFFSET ) );
+            player_transform->translation, Vector3Add( Vector3Multiply( v3_forward(), v3_scalar(PLAYER_CAPSULE_RADIUS) ), PLAYER_GROUND_CHECK_OFFSET ) );
         ground_check_end = Vector3Add(
             ground_check_start,
             Vector3Multiply( v3_down(), v3_scalar( PLAYER_GROUND_CHECK_DIST ) ) );
 
-        DrawLine3D( ground_check_start, ground_check_end, player->ground[0] ? RED : GREEN );
+        DrawLine3D( ground_check_start, ground_check_end, snapshot->player_ground[0] ? RED : GREEN );
 
         ground_check_start = Vector3Add( 
-            player->transform.translation, Vector3Add( Vector3Multiply( v3_back(), v3_scalar(PLAYER_CAPSULE_RADIUS) ), PLAYER_GROUND_CHECK_OFFSET ) );
+            player_transform->translation, Vector3Add( Vector3Multiply( v3_back(), v3_scalar(PLAYER_CAPSULE_RADIUS) ), PLAYER_GROUND_CHECK_OFFSET ) );
         ground_check_end = Vector3Add(
             ground_check_start,
             Vector3Multiply( v3_down(), v3_scalar( PLAYER_GROUND_CHECK_DIST ) ) );
 
-        DrawLine3D( ground_check_start, ground_check_end, player->ground[1] ? RED : GREEN );
+        DrawLine3D( ground_check_start, ground_check_end, snapshot->player_ground[1] ? RED : GREEN );
 
         ground_check_start = Vector3Add( 
-            player->transform.translation, Vector3Add( Vector3Multiply( v3_left(), v3_scalar(PLAYER_CAPSULE_RADIUS) ), PLAYER_GROUND_CHECK_OFFSET ) );
+            player_transform->translation, Vector3Add( Vector3Multiply( v3_left(), v3_scalar(PLAYER_CAPSULE_RADIUS) ), PLAYER_GROUND_CHECK_OFFSET ) );
         ground_check_end = Vector3Add(
             ground_check_start,
             Vector3Multiply( v3_down(), v3_scalar( PLAYER_GROUND_CHECK_DIST ) ) );
 
-        DrawLine3D( ground_check_start, ground_check_end, player->ground[2] ? RED : GREEN );
+        DrawLine3D( ground_check_start, ground_check_end, snapshot->player_ground[2] ? RED : GREEN );
 
         ground_check_start = Vector3Add( 
-            player->transform.translation, Vector3Add( Vector3Multiply( v3_right(), v3_scalar(PLAYER_CAPSULE_RADIUS) ), PLAYER_GROUND_CHECK_OFFSET ) );
+            player_transform->translation, Vector3Add( Vector3Multiply( v3_right(), v3_scalar(PLAYER_CAPSULE_RADIUS) ), PLAYER_GROUND_CHECK_OFFSET ) );
         ground_check_end = Vector3Add(
             ground_check_start,
             Vector3Multiply( v3_down(), v3_scalar( PLAYER_GROUND_CHECK_DIST ) ) );
 
-        DrawLine3D( ground_check_start, ground_check_end, player->ground[3] ? RED : GREEN );
+        DrawLine3D( ground_check_start, ground_check_end, snapshot->player_ground[3] ? RED : GREEN );
 
         Vector3 start =
-            Vector3Add( player->capsule.start, v3( 0.0f, PLAYER_CAPSULE_RADIUS, 0.0f ) );
+            Vector3Add( snapshot->player_capsule.start, v3( 0.0f, PLAYER_CAPSULE_RADIUS, 0.0f ) );
         Vector3 end =
-            Vector3Subtract( player->capsule.end, v3( 0.0f, PLAYER_CAPSULE_RADIUS, 0.0f ) );
+            Vector3Subtract( snapshot->player_capsule.end, v3( 0.0f, PLAYER_CAPSULE_RADIUS, 0.0f ) );
 
         DrawCapsuleWires(
             start, end,
-            player->capsule.radius, 8, 4, player->level_collision.hit ? RED : GREEN );
+            snapshot->player_capsule.radius, 8, 4, snapshot->player_hit ? RED : GREEN );
 
-        for( usize i = 0; i < state->level.object_count; ++i ) {
-            struct LevelObject* obj = state->level.objects + i;
+        for( u32 i = 0; i < snapshot->object_count; ++i ) {
+            const struct LevelObject* obj = state->level.objects + i;
             switch( obj->type ) {
                 case LOT_NULL: continue;
                 case LOT_STATIC: {
@@ -790,8 +1338,9 @@ void scene_game_draw( f32 dt, struct SceneGame* state ) {
                     }
                 } break;
                 case LOT_RESIZE: {
-                    DrawModelWires(
-                        obj->t_resize.col, v3_zero(), 1.0f, GREEN );
+                    Model col = obj->t_resize.col;
+                    col.transform = snapshot->object_transforms[i];
+                    DrawModelWires( col, v3_zero(), 1.0f, GREEN );
 
                     BoundingBox level_collision_bound =
                         GetMeshBoundingBox( obj->t_resize.col.meshes[0] );
@@ -806,25 +1355,39 @@ void scene_game_draw( f32 dt, struct SceneGame* state ) {
             }
         }
 
-        if( player->last_level_collision.hit ) {
-            debug_draw_point( player->last_level_collision.point, 0.2f, RED );
+        for( u32 i = 0; i < snapshot->actor_count; ++i ) {
+            if( i == snapshot->player_actor ) {
+                continue;
+            }
+            f32 radius  = snapshot->actor_radius[i];
+            Vector3 start = snapshot->actor_positions[i];
+            Vector3 end   = start;
+            end.y   += snapshot->actor_height[i] - radius;
+            start.y += radius;
+
+            Color color = snapshot->actor_kind[i] == ACTOR_PROP ? ORANGE : SKYBLUE;
+            DrawCapsuleWires( start, end, radius, 8, 4, color );
+        }
+
+        if( snapshot->player_last_collision.hit ) {
+            debug_draw_point( snapshot->player_last_collision.point, 0.2f, RED );
 
-            DrawLine3D( player->last_level_collision.point,
-                Vector3Add( player->last_level_collision.point,
-                    player->last_level_collision.normal ), YELLOW );
+            DrawLine3D( snapshot->player_last_collision.point,
+                Vector3Add( snapshot->player_last_collision.point,
+                    snapshot->player_last_collision.normal ), YELLOW );
 
-            DrawLine3D( player->last_level_collision.point,
-                Vector3Add( player->last_level_collision.point,
-                    Vector3Multiply(player->last_level_collision.normal,
-                        v3_scalar(player->last_level_collision.distance) ) ), MAGENTA);
+            DrawLine3D( snapshot->player_last_collision.point,
+                Vector3Add( snapshot->player_last_collision.point,
+                    Vector3Multiply(snapshot->player_last_collision.normal,
+                        v3_scalar(snapshot->player_last_collision.distance) ) ), MAGENTA);
 
             Vector3 up = v3_up();
-            Vector3 ortho_normal = player->last_level_collision.normal;
+            Vector3 ortho_normal = snapshot->player_last_collision.normal;
             if( absf(Vector3DotProduct( up, ortho_normal )) != 1.0f ) {
                 Vector3OrthoNormalize( &up, &ortho_normal );
             }
-            DrawLine3D( player->last_level_collision.point,
-                Vector3Add( player->last_level_collision.point,
+            DrawLine3D( snapshot->player_last_collision.point,
+                Vector3Add( snapshot->player_last_collision.point,
                     ortho_normal ), BLACK);
         }
 
@@ -832,6 +1395,7 @@ void scene_game_draw( f32 dt, struct SceneGame* state ) {
 #endif
 
     EndMode3D();
+    dynamic_resolution_end( resolution );
 
     Rectangle resize_time;
     resize_time.x = 20;
@@ -840,19 +1404,19 @@ void scene_game_draw( f32 dt, struct SceneGame* state ) {
     resize_time.height = 40;
     DrawRectangleRec( resize_time, BLACK );
     resize_time.width *=
-        (1.0f - (state->resize_allowed_timer / RESIZE_ON_TIME));
+        (1.0f - (snapshot->resize_allowed_timer / RESIZE_ON_TIME));
     DrawRectangleRec( resize_time, PURPLE );
 
-    if( player->is_dead ) {
-        f32 t = state->dead_timer / DEAD_TIME;
+    if( snapshot->player_dead ) {
+        f32 t = snapshot->dead_timer / DEAD_TIME;
         f32 scale = Lerp( 0.8f, 1.0f, t );
         gui_text_draw(
             font_title(), "YOU DIED",
             gui_screen_center(), TITLE_FONT_SIZE * scale,
             ANCHOR_CENTER, ANCHOR_CENTER, RED );
     }
-    if( player->won ) {
-        f32 t = state->won_timer / DEAD_TIME;
+    if( snapshot->player_won ) {
+        f32 t = snapshot->won_timer / DEAD_TIME;
         f32 scale = Lerp( 0.8f, 1.0f, t );
         gui_text_draw(
             font_title(), "LEVEL END",
@@ -871,12 +1435,12 @@ void scene_game_draw( f32 dt, struct SceneGame* state ) {
             TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
             col );
         gui_text_draw(
-            font, TextFormat("Position: %.2f, %.2f, %.2f", player->transform.translation.x, player->transform.translation.y, player->transform.translation.z ),
+            font, TextFormat("Position: %.2f, %.2f, %.2f", player_transform->translation.x, player_transform->translation.y, player_transform->translation.z ),
             v2( 0.0f, TEXT_FONT_SIZE_SMALLEST ),
             TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
             col);
         gui_text_draw(
-            font, TextFormat("Velocity: %.2f, %.2f, %.2f", player->velocity.x, player->velocity.y, player->velocity.z ),
+            font, TextFormat("Velocity: %.2f, %.2f, %.2f", snapshot->player_velocity.x, snapshot->player_velocity.y, snapshot->player_velocity.z ),
             v2( 0.0f, TEXT_FONT_SIZE_SMALLEST * 2 ),
             TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
             col);
@@ -885,6 +1449,86 @@ void scene_game_draw( f32 dt, struct SceneGame* state ) {
             v2( 0.0f, TEXT_FONT_SIZE_SMALLEST * 3 ),
             TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
             col);
+        gui_text_draw(
+            font, TextFormat("Contact cache: capsule %.1f%% ground %.1f%%",
+                snapshot->capsule_cache_hit_rate * 100.0f,
+                snapshot->ground_cache_hit_rate * 100.0f ),
+            v2( 0.0f, TEXT_FONT_SIZE_SMALLEST * 4 ),
+            TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
+            col);
+        gui_text_draw(
+            font, TextFormat("Level BVH: %u nodes, cost %.2fx, %llu refits, %llu rebuilds",
+                snapshot->bvh_node_count, snapshot->bvh_cost_ratio,
+                (unsigned long long)snapshot->bvh_refit_count,
+                (unsigned long long)snapshot->bvh_rebuild_count ),
+            v2( 0.0f, TEXT_FONT_SIZE_SMALLEST * 5 ),
+            TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
+            col);
+        gui_text_draw(
+            font, TextFormat("Actors: %u, %u pairs, %u contacts",
+                snapshot->actor_count, snapshot->actor_pair_count,
+                snapshot->actor_contact_count ),
+            v2( 0.0f, TEXT_FONT_SIZE_SMALLEST * 6 ),
+            TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
+            col);
+        const struct PhysicsCounters* counters = &snapshot->physics_counters;
+        gui_text_draw(
+            font, TextFormat(
+                "Physics: %llu objects, %llu bounds, %llu triangles, %llu rays, %llu hits",
+                (unsigned long long)counters->values[PHYSICS_COUNTER_OBJECTS],
+                (unsigned long long)counters->values[PHYSICS_COUNTER_BOUNDS_TESTS],
+                (unsigned long long)counters->values[PHYSICS_COUNTER_TRIANGLES],
+                (unsigned long long)counters->values[PHYSICS_COUNTER_RAYS],
+                (unsigned long long)counters->values[PHYSICS_COUNTER_HITS] ),
+            v2( 0.0f, TEXT_FONT_SIZE_SMALLEST * 7 ),
+            TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
+            col);
+        gui_text_draw(
+            font, TextFormat("Rewind: %u ticks, %.1fKiB",
+                snapshot->rewind_entry_count, snapshot->rewind_bytes_used / 1024.0f ),
+            v2( 0.0f, TEXT_FONT_SIZE_SMALLEST * 8 ),
+            TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
+            col);
+        gui_text_draw(
+            font, TextFormat("Draw: %u visible, %u culled, %u calls",
+                state->draw_count, state->cull_count, state->draw_call_count ),
+            v2( 0.0f, TEXT_FONT_SIZE_SMALLEST * 9 ),
+            TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
+            col);
+        gui_text_draw(
+            font, TextFormat("Anim: %s, frame cache %.1fKiB",
+                state->anim_cache_active ? "frame cache" : (
+                    state->gpu_skinning && state->player_gpu_skin.shader.id ?
+                    "gpu skinning" : "cpu skinning" ),
+                skin_cache_memory( &state->player_cache ) / 1024.0f ),
+            v2( 0.0f, TEXT_FONT_SIZE_SMALLEST * 10 ),
+            TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
+            col);
+        if( resolution->target.id ) {
+            int width, height;
+            dynamic_resolution_size( resolution, &width, &height );
+            gui_text_draw(
+                font, TextFormat(
+                    "Resolution: %.0f%% %ix%i%s, frame %.1fms / %.1fms, "
+                    "%u changes, last %.0f%% -> %.0f%% at %.1fms %.1fs ago",
+                    resolution->scale * 100.0f, width, height,
+                    resolution->enabled ? "" : " (fixed)",
+                    resolution->frame_time * 1000.0f, RENDER_FRAME_BUDGET * 1000.0f,
+                    resolution->change_count,
+                    resolution->change_from * 100.0f, resolution->change_to * 100.0f,
+                    resolution->change_frame_time * 1000.0f,
+                    resolution->change_count ?
+                        (f32)( GetTime() - resolution->change_at ) : 0.0f ),
+                v2( 0.0f, TEXT_FONT_SIZE_SMALLEST * 11 ),
+                TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
+                col);
+        } else {
+            gui_text_draw(
+                font, "Resolution: native, no render target",
+                v2( 0.0f, TEXT_FONT_SIZE_SMALLEST * 11 ),
+                TEXT_FONT_SIZE_SMALLEST, ANCHOR_START, ANCHOR_START,
+                col);
+        }
     }
 #endif
 
@@ -896,6 +1540,361 @@ void player_init( struct Player* player ) {
     player->transform.scale    = v3_one();
     player->max_velocity       = PLAYER_MAX_VELOCITY;
 }
+b32 level_object_capsule_collidable( struct LevelObject* obj ) {
+    if( obj->type == LOT_RESIZE && obj->t_resize.size.y < 0.1f ) {
+        return false;
+    }
+    return obj->collider != NULL;
+}
+static struct CollisionResult level_object_capsule(
+    struct Level* level, u32 object, Vector3 cap_start, Vector3 cap_end,
+    f32 radius, b32 use_sdf
+) {
+    struct LevelObject* obj = level->objects + object;
+    physics_counter_add( level->stats, PHYSICS_COUNTER_OBJECTS, 1 );
+    if( use_sdf && obj->type == LOT_STATIC && obj->t_static.sdf ) {
+        b32 saturated = false;
+        struct CollisionResult result = collision_sdf_capsule(
+            cap_start, cap_end, radius, obj->t_static.sdf,
+            obj->collider_transform, obj->collider_inverse, level->stats, &saturated );
+        if( !saturated ) {
+            return result;
+        }
+    }
+    return collision_mesh_capsule(
+        cap_start, cap_end, radius, obj->collider,
+        obj->collider_transform, obj->collider_inverse, level->stats );
+}
+
+struct CapsuleNarrowphase {
+    struct Level*  level;
+    Vector3        cap_start;
+    Vector3        cap_end;
+    f32            radius;
+    b32            use_sdf;
+    const u32*     candidates;
+    struct CollisionResult* results;
+};
+static void capsule_narrowphase_range( void* params, u32 begin, u32 end, u32 thread ) {
+    unused( thread );
+    struct CapsuleNarrowphase* narrowphase = params;
+    for( u32 i = begin; i < end; ++i ) {
+        narrowphase->results[i] = level_object_capsule(
+            narrowphase->level, narrowphase->candidates[i],
+            narrowphase->cap_start, narrowphase->cap_end,
+            narrowphase->radius, narrowphase->use_sdf );
+    }
+}
+
+struct CollisionResult level_capsule_query(
+    struct Level* level, Vector3 cap_start, Vector3 cap_end, f32 radius,
+    b32 use_sdf, u32* out_object
+) {
+    struct CollisionResult result;
+    memset( &result, 0, sizeof(result) );
+
+    BoundingBox cap_bound;
+    cap_bound.min = Vector3SubtractValue( Vector3Min( cap_start, cap_end ), radius );
+    cap_bound.max = Vector3AddValue( Vector3Max( cap_start, cap_end ), radius );
+
+    struct LevelBVHQuery query;
+    level_bvh_query( &level->bvh, cap_bound, level->stats, &query );
+
+    u32 candidates[LEVEL_QUERY_MAX_CANDIDATES];
+    struct CollisionResult results[LEVEL_QUERY_MAX_CANDIDATES];
+
+    b32 has_more = true;
+    while( has_more ) {
+        u32 candidate_count = 0;
+        u32 i = 0;
+        while(
+            candidate_count < LEVEL_QUERY_MAX_CANDIDATES &&
+            ( has_more = level_bvh_query_next( &query, &i ) )
+        ) {
+            if( level_object_capsule_collidable( level->objects + i ) ) {
+                candidates[candidate_count++] = i;
+            }
+        }
+
+        if( candidate_count < PHYSICS_JOB_MIN_CANDIDATES ) {
+            for( u32 j = 0; j < candidate_count; ++j ) {
+                result = level_object_capsule(
+                    level, candidates[j], cap_start, cap_end, radius, use_sdf );
+                if( result.hit ) {
+                    if( out_object ) {
+                        *out_object = candidates[j];
+                    }
+                    return result;
+                }
+            }
+            continue;
+        }
+
+        struct CapsuleNarrowphase narrowphase;
+        narrowphase.level      = level;
+        narrowphase.cap_start  = cap_start;
+        narrowphase.cap_end    = cap_end;
+        narrowphase.radius     = radius;
+        narrowphase.use_sdf    = use_sdf;
+        narrowphase.candidates = candidates;
+        narrowphase.results    = results;
+        job_parallel_for(
+            candidate_count, PHYSICS_JOB_BATCH,
+            capsule_narrowphase_range, &narrowphase );
+
+        // NOTE(alicia): merge in candidate order so the result
+        // matches the serial path regardless of thread count.
+        for( u32 j = 0; j < candidate_count; ++j ) {
+            if( results[j].hit ) {
+                if( out_object ) {
+                    *out_object = candidates[j];
+                }
+                return results[j];
+            }
+        }
+    }
+
+    memset( &result, 0, sizeof(result) );
+    return result;
+}
+
+struct CapsuleQueryBatch {
+    struct Level*              level;
+    const struct CapsuleQuery* queries;
+    b32                        use_sdf;
+    struct CollisionResult*    results;
+    u32*                       objects;
+};
+static void capsule_query_batch_range( void* params, u32 begin, u32 end, u32 thread ) {
+    unused( thread );
+    struct CapsuleQueryBatch* batch = params;
+    for( u32 i = begin; i < end; ++i ) {
+        const struct CapsuleQuery* query = batch->queries + i;
+        u32 object = 0;
+        batch->results[i] = level_capsule_query(
+            batch->level, query->start, query->end, query->radius,
+            batch->use_sdf, &object );
+        if( batch->objects ) {
+            batch->objects[i] = object;
+        }
+    }
+}
+void level_capsule_query_batch(
+    struct Level* level, const struct CapsuleQuery* queries, u32 count,
+    b32 use_sdf, struct CollisionResult* out_results, u32* opt_out_objects
+) {
+    struct CapsuleQueryBatch batch;
+    batch.level   = level;
+    batch.queries = queries;
+    batch.use_sdf = use_sdf;
+    batch.results = out_results;
+    batch.objects = opt_out_objects;
+    job_parallel_for( count, CAPSULE_QUERY_BATCH, capsule_query_batch_range, &batch );
+}
+
+void level_actors_step(
+    struct Level* level, struct ActorPool* actors, b32 use_sdf, f32 dt
+) {
+    f32 gravity = GRAVITY_SCALE * GRAVITY * dt;
+
+    u32 query_count = 0;
+    for( u32 i = 0; i < actors->count; ++i ) {
+        if( !actor_collides_level( actors, i ) ) {
+            continue;
+        }
+        query_count++;
+
+        Vector3 velocity = actor_velocity( actors, i );
+        if( actors->flags[i] & ACTOR_FLAG_GROUNDED ) {
+            velocity = velocity_apply_drag( velocity, ACTOR_DRAG, dt );
+        }
+        velocity.y += gravity;
+        actor_set_velocity( actors, i, velocity );
+        actor_set_position( actors, i, Vector3Add(
+            actor_position( actors, i ), Vector3Scale( velocity, dt ) ) );
+    }
+
+    if( query_count ) {
+        struct CapsuleQuery*    queries = actors->level_queries;
+        struct CollisionResult* results = actors->level_results;
+        u32*                    owners  = actors->level_owners;
+
+        u32 query = 0;
+        for( u32 i = 0; i < actors->count; ++i ) {
+            if( !actor_collides_level( actors, i ) ) {
+                continue;
+            }
+            owners[query] = i;
+            actor_capsule( actors, i, &queries[query].start, &queries[query].end );
+            queries[query].radius = actors->radius[i];
+            query++;
+        }
+
+        level_capsule_query_batch(
+            level, queries, query_count, use_sdf, results, NULL );
+
+        for( u32 j = 0; j < query_count; ++j ) {
+            u32 i = owners[j];
+            actors->flags[i] &= ~ACTOR_FLAG_GROUNDED;
+
+            struct CollisionResult* result = results + j;
+            if( !result->hit ) {
+                continue;
+            }
+
+            actor_set_position( actors, i, Vector3Add(
+                actor_position( actors, i ),
+                Vector3Scale( result->normal, result->distance + EPSILON ) ) );
+
+            Vector3 velocity = actor_velocity( actors, i );
+            f32 dot = Vector3DotProduct( velocity, result->normal );
+            if( dot < 0.0f ) {
+                velocity = Vector3Subtract(
+                    velocity, Vector3Scale( result->normal, dot ) );
+                actor_set_velocity( actors, i, velocity );
+            }
+            if( result->normal.y >= ACTOR_GROUND_NORMAL_Y ) {
+                actors->flags[i] |= ACTOR_FLAG_GROUNDED;
+            }
+        }
+    }
+
+    for( u32 i = actors->count; i-- > 0; ) {
+        if( actor_collides_level( actors, i ) && actors->position_y[i] < KILL_PLANE ) {
+            actor_despawn( actors, i );
+        }
+    }
+
+    actor_pool_broadphase( actors );
+    actor_pool_resolve( actors );
+}
+
+RayCollision level_ground_probe(
+    struct Level* level, Vector3 origin, f32 max_distance,
+    u32* out_object, i32* out_triangle
+) {
+    RayCollision result;
+    memset( &result, 0, sizeof(result) );
+
+    Ray ray;
+    ray.position  = origin;
+    ray.direction = v3_down();
+
+    BoundingBox bounds;
+    bounds.min    = origin;
+    bounds.max    = origin;
+    bounds.min.y -= max_distance;
+
+    struct LevelBVHQuery query;
+    level_bvh_query( &level->bvh, bounds, level->stats, &query );
+
+    u32 i = 0;
+    while( level_bvh_query_next( &query, &i ) ) {
+        struct LevelObject* obj = level->objects + i;
+        if( !obj->collider ) {
+            continue;
+        }
+
+        physics_counter_add( level->stats, PHYSICS_COUNTER_OBJECTS, 1 );
+        i32 triangle = 0;
+        f32 distance = result.hit ? result.distance : max_distance;
+        RayCollision collision = collision_mesh_ray(
+            ray, distance, obj->collider, obj->collider_inverse,
+            level->stats, &triangle );
+        if( collision.hit && collision.distance <= distance ) {
+            result        = collision;
+            *out_object   = i;
+            *out_triangle = triangle;
+        }
+    }
+
+    return result;
+}
+
+struct GroundProbes {
+    struct Level*  level;
+    const Vector3* origins;
+    RayCollision*  hits;
+    u32*           objects;
+    i32*           triangles;
+};
+static void ground_probe_range( void* params, u32 begin, u32 end, u32 thread ) {
+    unused( thread );
+    struct GroundProbes* probes = params;
+    for( u32 i = begin; i < end; ++i ) {
+        probes->hits[i] = level_ground_probe(
+            probes->level, probes->origins[i], PLAYER_GROUND_CHECK_DIST,
+            probes->objects + i, probes->triangles + i );
+    }
+}
+
+/// Collects triangles near capsule so following ticks can skip the
+/// level and mesh BVHs while capsule stays inside the margin.
+/// Leaves cache invalid if there are too many or an SDF is in the way.
+static void capsule_cache_fill(
+    struct Level* level, struct CapsuleCache* cache, BoundingBox cap_bound, b32 use_sdf
+) {
+    capsule_cache_invalidate( cache );
+
+    BoundingBox bounds;
+    bounds.min = Vector3SubtractValue( cap_bound.min, CAPSULE_CACHE_MARGIN );
+    bounds.max = Vector3AddValue( cap_bound.max, CAPSULE_CACHE_MARGIN );
+
+    struct LevelBVHQuery query;
+    level_bvh_query( &level->bvh, bounds, level->stats, &query );
+
+    u32 count = 0;
+    u32 i     = 0;
+    while( level_bvh_query_next( &query, &i ) ) {
+        struct LevelObject* obj = level->objects + i;
+        if( !level_object_capsule_collidable( obj ) ) {
+            continue;
+        }
+        // NOTE(alicia): sdf contacts have no triangles to cache.
+        if( use_sdf && obj->type == LOT_STATIC && obj->t_static.sdf ) {
+            capsule_cache_invalidate( cache );
+            return;
+        }
+
+        u32 room = CAPSULE_CACHE_MAX_CANDIDATES - count;
+        u32 found = collision_mesh_query_box(
+            obj->collider, bounds_transform( bounds, obj->collider_inverse ),
+            level->stats, cache->triangles + count, room );
+        if( found >= room ) {
+            capsule_cache_invalidate( cache );
+            return;
+        }
+        for( u32 j = 0; j < found; ++j ) {
+            cache->objects[count + j] = i;
+        }
+        count += found;
+    }
+
+    cache->valid  = true;
+    cache->bounds = bounds;
+    cache->count  = count;
+}
+/// Same result as level_capsule_query as long as capsule is
+/// inside cache bounds: any triangle it skips can't touch capsule
+/// and candidates are tested in the same order.
+static struct CollisionResult capsule_cache_query(
+    struct Level* level, const struct CapsuleCache* cache,
+    Vector3 cap_start, Vector3 cap_end, f32 radius
+) {
+    struct CollisionResult result;
+    memset( &result, 0, sizeof(result) );
+    for( u32 i = 0; i < cache->count; ++i ) {
+        struct LevelObject* obj = level->objects + cache->objects[i];
+        result = collision_mesh_capsule_triangle(
+            cap_start, cap_end, radius, obj->collider,
+            obj->collider_transform, (i32)cache->triangles[i], level->stats );
+        if( result.hit ) {
+            return result;
+        }
+    }
+    memset( &result, 0, sizeof(result) );
+    return result;
+}
 void player_physics( struct Player* player, struct SceneGame* scene, f32 dt ) {
     unused(scene);
 
@@ -908,47 +1907,34 @@ void player_physics( struct Player* player, struct SceneGame* scene, f32 dt ) {
         struct CollisionResult level_collision;
         memset( &level_collision, 0, sizeof( level_collision ) );
 
-        for( usize i = 0; i < scene->level.object_count; ++i ) {
-            struct LevelObject* obj = scene->level.objects + i;
-            switch( obj->type ) {
-                case LOT_NULL: continue;
-                case LOT_STATIC: {
-                    if( !obj->t_static.has_col ) {
-                        continue;
-                    }
-                    Matrix level_mat =
-                        MatrixTranslate(
-                            obj->t_static.offset.x,
-                            obj->t_static.offset.y,
-                            obj->t_static.offset.z );
-
-                    level_collision = collision_capsule_mesh(
-                        player->capsule.start, player->capsule.end,
-                        player->capsule.radius, level_mat,
-                        obj->t_static.col.meshes[0] );
-
-                    if( level_collision.hit ) {
-                        goto exit_collision_check;
-                    }
-                } break;
-                case LOT_RESIZE: {
-                    if(
-                        obj->t_resize.size.y < 0.1f 
-                    ) {
-                        memset( &level_collision, 0, sizeof( level_collision ) );
-                    } else {
-                        level_collision = collision_capsule_mesh(
-                            player->capsule.start, player->capsule.end,
-                            player->capsule.radius, obj->t_resize.col.transform,
-                            obj->t_resize.col.meshes[0] );
-                    }
-                    if( level_collision.hit ) {
-                        goto exit_collision_check;
-                    }
-                } break;
-            }
+        // NOTE(alicia): player barely moves between ticks so
+        // triangles around last query's capsule are reused
+        // until capsule leaves the margin around them.
+        BoundingBox cap_bound;
+        cap_bound.min = Vector3SubtractValue(
+            Vector3Min( player->capsule.start, player->capsule.end ),
+            player->capsule.radius );
+        cap_bound.max = Vector3AddValue(
+            Vector3Max( player->capsule.start, player->capsule.end ),
+            player->capsule.radius );
+
+        struct CapsuleCache* cache = &scene->capsule_cache;
+        if( cache->valid && bounds_contains( cache->bounds, cap_bound ) ) {
+            scene->capsule_cache_counters.hits++;
+        } else {
+            scene->capsule_cache_counters.misses++;
+            capsule_cache_fill( &scene->level, cache, cap_bound, scene->use_sdf );
+        }
+
+        if( cache->valid ) {
+            level_collision = capsule_cache_query(
+                &scene->level, cache, player->capsule.start,
+                player->capsule.end, player->capsule.radius );
+        } else {
+            level_collision = level_capsule_query(
+                &scene->level, player->capsule.start, player->capsule.end,
+                player->capsule.radius, scene->use_sdf, NULL );
         }
-    exit_collision_check:
 
         if( level_collision.hit ) {
 #if defined(DEBUG)
@@ -965,67 +1951,75 @@ void player_physics( struct Player* player, struct SceneGame* scene, f32 dt ) {
     Ray ray;
     ray.direction = v3_down();
 
-    for( usize i = 0; i < scene->level.object_count; ++i ) {
-        struct LevelObject* obj = scene->level.objects + i;
-        Mesh col;
-        Matrix transform;
-        switch( obj->type ) {
-            case LOT_NULL: continue;
-            case LOT_STATIC: {
-                if( !obj->t_static.has_col ) {
-                    continue;
-                }
-                col = obj->t_static.col.meshes[0];
-                transform = MatrixTranslate(
-                    obj->t_static.offset.x,
-                    obj->t_static.offset.y,
-                    obj->t_static.offset.z );
-            } break;
-            case LOT_RESIZE: {
-                col       = obj->t_resize.col.meshes[0];
-                transform = obj->t_resize.col.transform;
-            } break;
-        }
-
-        ray.position  = Vector3Add(
-            player->transform.translation,
-            Vector3Add( Vector3Multiply( v3_forward(), v3_scalar( PLAYER_CAPSULE_RADIUS )), PLAYER_GROUND_CHECK_OFFSET ));
-        ray_collision = GetRayCollisionMesh( 
-            ray, col, transform );
-        ground[0] =
-            ray_collision.hit && ray_collision.distance <= PLAYER_GROUND_CHECK_DIST;
-
-        ray.position  = Vector3Add(
+    Vector3 ground_check_directions[4] = {
+        v3_forward(), v3_back(), v3_left(), v3_right()
+    };
+    Vector3 ground_check_origins[4];
+    for( usize i = 0; i < 4; ++i ) {
+        ground_check_origins[i] = Vector3Add(
             player->transform.translation,
-            Vector3Add( Vector3Multiply( v3_back(), v3_scalar( PLAYER_CAPSULE_RADIUS )), PLAYER_GROUND_CHECK_OFFSET ));
-        ray_collision = GetRayCollisionMesh( 
-            ray, col, transform );
-        ground[1] =
-            ray_collision.hit && ray_collision.distance <= PLAYER_GROUND_CHECK_DIST;
+            Vector3Add(
+                Vector3Multiply(
+                    ground_check_directions[i], v3_scalar( PLAYER_CAPSULE_RADIUS )),
+                PLAYER_GROUND_CHECK_OFFSET ));
+    }
 
-        ray.position  = Vector3Add(
-            player->transform.translation,
-            Vector3Add( Vector3Multiply( v3_left(), v3_scalar( PLAYER_CAPSULE_RADIUS )), PLAYER_GROUND_CHECK_OFFSET ));
-        ray_collision = GetRayCollisionMesh( 
-            ray, col, transform );
-        ground[2] =
-            ray_collision.hit && ray_collision.distance <= PLAYER_GROUND_CHECK_DIST;
+    player->is_grounded = false;
+
+    struct CollisionCache* ground_cache = &scene->ground_cache;
+    if( ground_cache->valid && ground_cache->object < scene->level.object_count ) {
+        struct LevelObject* obj = scene->level.objects + ground_cache->object;
+        if( obj->collider ) {
+            physics_counter_add( scene->level.stats, PHYSICS_COUNTER_OBJECTS, 1 );
+            for( usize i = 0; i < 4; ++i ) {
+                ray.position  = ground_check_origins[i];
+                ray_collision = collision_mesh_ray_triangle(
+                    ray, obj->collider, obj->collider_inverse,
+                    ground_cache->triangle, scene->level.stats );
+                ground[i] =
+                    ray_collision.hit &&
+                    ray_collision.distance <= PLAYER_GROUND_CHECK_DIST;
+            }
+            player->is_grounded = ground[0] || ground[1] || ground[2] || ground[3];
+        }
+    }
 
-        ray.position  = Vector3Add(
-            player->transform.translation,
-            Vector3Add( Vector3Multiply( v3_right(), v3_scalar( PLAYER_CAPSULE_RADIUS )), PLAYER_GROUND_CHECK_OFFSET ));
-        ray_collision = GetRayCollisionMesh( 
-            ray, col, transform );
-        ground[3] =
-            ray_collision.hit && ray_collision.distance <= PLAYER_GROUND_CHECK_DIST;
+    if( player->is_grounded ) {
+        scene->ground_cache_counters.hits++;
+#if defined(DEBUG)
+        memcpy( player->ground, ground, sizeof(ground) );
+#endif
+    } else {
+        scene->ground_cache_counters.misses++;
+        collision_cache_invalidate( ground_cache );
+
+        RayCollision hits[4];
+        u32 objects[4];
+        i32 triangles[4];
+
+        struct GroundProbes probes;
+        probes.level     = &scene->level;
+        probes.origins   = ground_check_origins;
+        probes.hits      = hits;
+        probes.objects   = objects;
+        probes.triangles = triangles;
+
+        // NOTE(alicia): four short rays through the BVH cost less than
+        // waking workers for them, job fan-out is kept for capsule and
+        // actor batches where there's enough work to split.
+        ground_probe_range( &probes, 0, 4, job_thread_index() );
+
+        for( usize i = 0; i < 4; ++i ) {
+            ground[i] = hits[i].hit;
+            if( ground[i] && !ground_cache->valid ) {
+                collision_cache_store( ground_cache, objects[i], triangles[i] );
+            }
+        }
 
         player->is_grounded = ground[0] || ground[1] || ground[2] || ground[3];
 #if defined(DEBUG)
         memcpy( player->ground, ground, sizeof(ground) );
 #endif
-        if( player->is_grounded ) {
-            break;
-        }
     }
 
     if( !player->is_grounded ) {
@@ -1068,6 +2062,377 @@ void player_physics( struct Player* player, struct SceneGame* scene, f32 dt ) {
     f32 drag = player->input.is_moving ? PLAYER_DRAG : PLAYER_DRAG * 2.0f;
     player->velocity = velocity_apply_drag( player->velocity, drag, dt );
 }
+static u64 hash_bytes( u64 hash, const void* data, usize size ) {
+    const u8* bytes = data;
+    for( usize i = 0; i < size; ++i ) {
+        hash ^= bytes[i];
+        hash *= 0x100000001B3ull;
+    }
+    return hash;
+}
+#define hash_value( hash, value ) hash_bytes( hash, &(value), sizeof(value) )
+
+u64 scene_game_hash( const struct SceneGame* state ) {
+    const struct Player* player = &state->player;
+
+    // NOTE(alicia): fields are hashed one by one so struct
+    // padding never ends up in the hash.
+    u64 hash = 0xCBF29CE484222325ull;
+    hash = hash_value( hash, player->transform.translation );
+    hash = hash_value( hash, player->transform.rotation );
+    hash = hash_value( hash, player->velocity );
+    hash = hash_value( hash, player->camera_rotation );
+    hash = hash_value( hash, player->max_velocity );
+    hash = hash_value( hash, player->is_grounded );
+    hash = hash_value( hash, player->is_dead );
+    hash = hash_value( hash, player->won );
+
+    hash = hash_value( hash, state->camera.position );
+    hash = hash_value( hash, state->camera.target );
+
+    hash = hash_value( hash, state->last_dead );
+    hash = hash_value( hash, state->last_resize_enabled );
+    hash = hash_value( hash, state->resize_enabled );
+    hash = hash_value( hash, state->resize_banned );
+    hash = hash_value( hash, state->resize_reverse );
+    hash = hash_value( hash, state->resize_timer );
+    hash = hash_value( hash, state->resize_allowed_timer );
+    hash = hash_value( hash, state->dead_timer );
+    hash = hash_value( hash, state->won_timer );
+
+    for( usize i = 0; i < state->level.object_count; ++i ) {
+        const struct LevelObject* obj = state->level.objects + i;
+        if( obj->type == LOT_RESIZE ) {
+            hash = hash_value( hash, obj->t_resize.size );
+        }
+    }
+
+    const struct ActorPool* actors = &state->actors;
+    hash = hash_value( hash, actors->count );
+    hash = hash_bytes( hash, actors->position_x, sizeof(f32) * actors->count );
+    hash = hash_bytes( hash, actors->position_y, sizeof(f32) * actors->count );
+    hash = hash_bytes( hash, actors->position_z, sizeof(f32) * actors->count );
+    hash = hash_bytes( hash, actors->velocity_x, sizeof(f32) * actors->count );
+    hash = hash_bytes( hash, actors->velocity_y, sizeof(f32) * actors->count );
+    hash = hash_bytes( hash, actors->velocity_z, sizeof(f32) * actors->count );
+
+    return hash;
+}
+
+struct GameSnapshotHeader {
+    struct Player player;
+    Camera3D      camera;
+
+    b32 last_dead;
+    f32 resize_allowed_timer;
+    b32 resize_banned;
+    b32 last_resize_enabled;
+    b32 resize_enabled;
+    f32 resize_timer;
+    b32 resize_reverse;
+    f32 dead_timer;
+    f32 won_timer;
+    int current_animation;
+
+    struct CapsuleCache   capsule_cache;
+    struct CollisionCache ground_cache;
+
+    u32 object_count;
+    u32 resize_count;
+    u32 bvh_node_count;
+    u32 bvh_order_count;
+    f32 bvh_build_cost;
+    f32 bvh_cost;
+    u32 actor_count;
+};
+
+static usize snapshot_size( const struct GameSnapshotHeader* header, u32 bvh_object_count ) {
+    return
+        sizeof(*header) +
+        sizeof(Vector3) * (usize)header->resize_count +
+        sizeof(BoundingBox) * (usize)bvh_object_count +
+        sizeof(u32) * (usize)header->bvh_order_count +
+        sizeof(struct BVHNode) * (usize)header->bvh_node_count +
+        ( sizeof(f32) * 9 + sizeof(u8) * 2 + sizeof(u32) ) * (usize)header->actor_count;
+}
+static u8* snapshot_write( u8* at, const void* src, usize size ) {
+    memcpy( at, src, size );
+    return at + size;
+}
+static const u8* snapshot_read( const u8* at, void* dst, usize size ) {
+    memcpy( dst, at, size );
+    return at + size;
+}
+/// cache is only kept if it points at a triangle of the loaded level.
+static void snapshot_cache_check(
+    const struct Level* level, struct CollisionCache* cache
+) {
+    if( !cache->valid ) {
+        return;
+    }
+    const struct CollisionMesh* collider = NULL;
+    if( cache->object < level->object_count ) {
+        collider = level->objects[cache->object].collider;
+    }
+    if(
+        !collider || cache->triangle < 0 ||
+        (u32)cache->triangle >= collider->triangle_count
+    ) {
+        collision_cache_invalidate( cache );
+    }
+}
+static void snapshot_capsule_cache_check(
+    const struct Level* level, struct CapsuleCache* cache
+) {
+    if( !cache->valid ) {
+        return;
+    }
+    if( cache->count > CAPSULE_CACHE_MAX_CANDIDATES ) {
+        capsule_cache_invalidate( cache );
+        return;
+    }
+    for( u32 i = 0; i < cache->count; ++i ) {
+        const struct CollisionMesh* collider = NULL;
+        if( cache->objects[i] < level->object_count ) {
+            collider = level->objects[cache->objects[i]].collider;
+        }
+        if( !collider || cache->triangles[i] >= collider->triangle_count ) {
+            capsule_cache_invalidate( cache );
+            return;
+        }
+    }
+}
+/// checks every index stored in snapshot, at points past header.
+/// counts and size have to be checked already.
+static b32 snapshot_indices_valid(
+    const struct GameSnapshotHeader* header, u32 bvh_object_count, const u8* at
+) {
+    at += sizeof(Vector3) * (usize)header->resize_count;
+    at += sizeof(BoundingBox) * (usize)bvh_object_count;
+
+    for( u32 i = 0; i < header->bvh_order_count; ++i ) {
+        u32 object = 0;
+        at = snapshot_read( at, &object, sizeof(object) );
+        if( object >= bvh_object_count ) {
+            return false;
+        }
+    }
+
+    // NOTE(alicia): children always come after their parent,
+    // that rules out cycles. traversal is then walked once
+    // to make sure no query can overflow its stack.
+    const u8* nodes = at;
+    for( u32 i = 0; i < header->bvh_node_count; ++i ) {
+        struct BVHNode node;
+        at = snapshot_read( at, &node, sizeof(node) );
+        if( node.count ) {
+            if(
+                node.first > header->bvh_order_count ||
+                node.count > header->bvh_order_count - node.first
+            ) {
+                return false;
+            }
+        } else if( node.first <= i || node.first + 1 >= header->bvh_node_count ) {
+            return false;
+        }
+    }
+    if( header->bvh_node_count ) {
+        u32 stack[LEVEL_BVH_STACK_SIZE];
+        u32 stack_count = 0;
+        stack[stack_count++] = 0;
+        while( stack_count ) {
+            struct BVHNode node;
+            snapshot_read(
+                nodes + sizeof(node) * (usize)stack[--stack_count], &node, sizeof(node) );
+            if( node.count ) {
+                continue;
+            }
+            if( stack_count + 2 > LEVEL_BVH_STACK_SIZE ) {
+                return false;
+            }
+            stack[stack_count++] = node.first + 1;
+            stack[stack_count++] = node.first;
+        }
+    }
+
+    at += ( sizeof(f32) * 9 + sizeof(u8) * 2 ) * (usize)header->actor_count;
+    for( u32 i = 0; i < header->actor_count; ++i ) {
+        u32 actor = 0;
+        at = snapshot_read( at, &actor, sizeof(actor) );
+        if( actor >= header->actor_count ) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void scene_game_snapshot_take(
+    const struct SceneGame* state, struct GameSnapshot* snapshot
+) {
+    const struct Level*     level  = &state->level;
+    const struct ActorPool* actors = &state->actors;
+
+    struct GameSnapshotHeader header;
+    memset( &header, 0, sizeof(header) );
+    header.player               = state->player;
+    header.camera               = state->camera;
+    header.last_dead            = state->last_dead;
+    header.resize_allowed_timer = state->resize_allowed_timer;
+    header.resize_banned        = state->resize_banned;
+    header.last_resize_enabled  = state->last_resize_enabled;
+    header.resize_enabled       = state->resize_enabled;
+    header.resize_timer         = state->resize_timer;
+    header.resize_reverse       = state->resize_reverse;
+    header.dead_timer           = state->dead_timer;
+    header.won_timer            = state->won_timer;
+    header.current_animation    = state->current_animation;
+    header.capsule_cache        = state->capsule_cache;
+    header.ground_cache         = state->ground_cache;
+    header.object_count         = (u32)level->object_count;
+    header.bvh_node_count       = level->bvh.node_count;
+    header.bvh_order_count      = level->bvh.order_count;
+    header.bvh_build_cost       = level->bvh.build_cost;
+    header.bvh_cost             = level->bvh.cost;
+    header.actor_count          = actors->count;
+    for( usize i = 0; i < level->object_count; ++i ) {
+        header.resize_count += level->objects[i].type == LOT_RESIZE ? 1 : 0;
+    }
+
+    // NOTE(alicia): BVH layout and actor sweep order decide the order
+    // contacts are found in, they have to come back exactly as they were.
+    usize size = snapshot_size( &header, level->bvh.object_count );
+
+    if( size > snapshot->capacity ) {
+        snapshot->data     = MemRealloc( snapshot->data, size );
+        snapshot->capacity = size;
+    }
+    snapshot->size = size;
+
+    u8* at = snapshot_write( snapshot->data, &header, sizeof(header) );
+    for( usize i = 0; i < level->object_count; ++i ) {
+        const struct LevelObject* obj = level->objects + i;
+        if( obj->type == LOT_RESIZE ) {
+            at = snapshot_write( at, &obj->t_resize.size, sizeof(Vector3) );
+        }
+    }
+
+    at = snapshot_write(
+        at, level->bvh.bounds, sizeof(BoundingBox) * level->bvh.object_count );
+    at = snapshot_write( at, level->bvh.order, sizeof(u32) * header.bvh_order_count );
+    at = snapshot_write(
+        at, level->bvh.nodes, sizeof(struct BVHNode) * header.bvh_node_count );
+
+    u32 count = actors->count;
+    at = snapshot_write( at, actors->position_x,   sizeof(f32) * count );
+    at = snapshot_write( at, actors->position_y,   sizeof(f32) * count );
+    at = snapshot_write( at, actors->position_z,   sizeof(f32) * count );
+    at = snapshot_write( at, actors->velocity_x,   sizeof(f32) * count );
+    at = snapshot_write( at, actors->velocity_y,   sizeof(f32) * count );
+    at = snapshot_write( at, actors->velocity_z,   sizeof(f32) * count );
+    at = snapshot_write( at, actors->radius,       sizeof(f32) * count );
+    at = snapshot_write( at, actors->height,       sizeof(f32) * count );
+    at = snapshot_write( at, actors->inverse_mass, sizeof(f32) * count );
+    at = snapshot_write( at, actors->kind,         sizeof(u8)  * count );
+    at = snapshot_write( at, actors->flags,        sizeof(u8)  * count );
+    at = snapshot_write( at, actors->sweep_order,  sizeof(u32) * count );
+}
+b32 scene_game_snapshot_restore(
+    struct SceneGame* state, const struct GameSnapshot* snapshot
+) {
+    struct Level*     level  = &state->level;
+    struct ActorPool* actors = &state->actors;
+
+    // NOTE(alicia): replay keyframes come from disk,
+    // every count is checked before anything is copied.
+    struct GameSnapshotHeader header;
+    if( !snapshot->data || snapshot->size < sizeof(header) ) {
+        return false;
+    }
+    const u8* at = snapshot_read( snapshot->data, &header, sizeof(header) );
+
+    u32 resize_count = 0;
+    for( usize i = 0; i < level->object_count; ++i ) {
+        resize_count += level->objects[i].type == LOT_RESIZE ? 1 : 0;
+    }
+    u32 object_count = level->bvh.object_count;
+    u32 max_nodes    = object_count ? object_count * 2 - 1 : 0;
+    if(
+        header.object_count    != level->object_count ||
+        header.resize_count    != resize_count ||
+        header.bvh_order_count >  object_count ||
+        header.bvh_node_count  >  max_nodes ||
+        header.actor_count     >  actors->capacity ||
+        snapshot_size( &header, object_count ) != snapshot->size
+    ) {
+        TraceLog( LOG_WARNING, "Snapshot does not match loaded level!" );
+        return false;
+    }
+    if(
+        ( state->player_actor != U32_MAX && header.actor_count <= state->player_actor ) ||
+        !snapshot_indices_valid( &header, object_count, at )
+    ) {
+        TraceLog( LOG_WARNING, "Snapshot is corrupt!" );
+        return false;
+    }
+    snapshot_capsule_cache_check( level, &header.capsule_cache );
+    snapshot_cache_check( level, &header.ground_cache );
+
+    state->player               = header.player;
+    state->camera               = header.camera;
+    state->last_dead            = header.last_dead;
+    state->resize_allowed_timer = header.resize_allowed_timer;
+    state->resize_banned        = header.resize_banned;
+    state->last_resize_enabled  = header.last_resize_enabled;
+    state->resize_enabled       = header.resize_enabled;
+    state->resize_timer         = header.resize_timer;
+    state->resize_reverse       = header.resize_reverse;
+    state->dead_timer           = header.dead_timer;
+    state->won_timer            = header.won_timer;
+    state->current_animation    = header.current_animation;
+    state->capsule_cache        = header.capsule_cache;
+    state->ground_cache         = header.ground_cache;
+
+    for( usize i = 0; i < level->object_count; ++i ) {
+        struct LevelObject* obj = level->objects + i;
+        if( obj->type == LOT_RESIZE ) {
+            at = snapshot_read( at, &obj->t_resize.size, sizeof(Vector3) );
+            level_object_update_transform( obj );
+        }
+    }
+
+    at = snapshot_read(
+        at, level->bvh.bounds, sizeof(BoundingBox) * level->bvh.object_count );
+    at = snapshot_read( at, level->bvh.order, sizeof(u32) * header.bvh_order_count );
+    at = snapshot_read(
+        at, level->bvh.nodes, sizeof(struct BVHNode) * header.bvh_node_count );
+    level->bvh.order_count = header.bvh_order_count;
+    level->bvh.node_count  = header.bvh_node_count;
+    level->bvh.build_cost  = header.bvh_build_cost;
+    level->bvh.cost        = header.bvh_cost;
+
+    u32 count = header.actor_count;
+    at = snapshot_read( at, actors->position_x,   sizeof(f32) * count );
+    at = snapshot_read( at, actors->position_y,   sizeof(f32) * count );
+    at = snapshot_read( at, actors->position_z,   sizeof(f32) * count );
+    at = snapshot_read( at, actors->velocity_x,   sizeof(f32) * count );
+    at = snapshot_read( at, actors->velocity_y,   sizeof(f32) * count );
+    at = snapshot_read( at, actors->velocity_z,   sizeof(f32) * count );
+    at = snapshot_read( at, actors->radius,       sizeof(f32) * count );
+    at = snapshot_read( at, actors->height,       sizeof(f32) * count );
+    at = snapshot_read( at, actors->inverse_mass, sizeof(f32) * count );
+    at = snapshot_read( at, actors->kind,         sizeof(u8)  * count );
+    at = snapshot_read( at, actors->flags,        sizeof(u8)  * count );
+    at = snapshot_read( at, actors->sweep_order,  sizeof(u32) * count );
+    actors->count         = count;
+    actors->pair_count    = 0;
+    actors->contact_count = 0;
+    return true;
+}
+void scene_game_snapshot_free( struct GameSnapshot* snapshot ) {
+    MemFree( snapshot->data );
+    memset( snapshot, 0, sizeof(*snapshot) );
+}
+
 void input_read( struct Input* input ) {
     memset( input, 0, sizeof(*input) );
 
@@ -1084,11 +2449,14 @@ void input_read( struct Input* input ) {
     input->move = Vector2ClampValue( input->move, 0.0f, 1.0f );
 
     input->rotation = GetMouseDelta();
-    input->rotation.x *= -1.0f;
+    // NOTE(alicia): subtract instead of negate so a still
+    // mouse reads as 0 rather than -0, keeps replays small.
+    input->rotation.x = 0.0f - input->rotation.x;
 
     input->jump      = IsKeyPressed( KEY_SPACE );
     input->jump_hold = IsKeyDown( KEY_SPACE );
     input->run_hold  = IsKeyDown( KEY_LEFT_SHIFT );
 
     input->resize_hold = IsMouseButtonDown(MOUSE_BUTTON_LEFT);
+    input->rewind_hold = IsKeyDown( KEY_Q );
 }
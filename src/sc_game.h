@@ -8,6 +8,12 @@
 */
 #include "common.h"
 #include "physics.h"
+#include "sdf.h"
+#include "actor.h"
+#include "rewind.h"
+#include "render.h"
+#include "skin.h"
+#include "anim.h"
 
 #define CAMERA_OFFSET v3( 0.0f, 1.8f, -3.0f )
 #define CAMERA_TARGET_OFFSET v3( 0.0f, 0.8f, 0.0f )
@@ -29,10 +35,22 @@
 
 #define PLAYER_JUMP_FORCE (6.5f)
 
+/// Candidates gathered from level BVH per narrowphase pass.
+#define LEVEL_QUERY_MAX_CANDIDATES (128)
+/// Narrowphase only fans out across workers past this many candidates.
+#define PHYSICS_JOB_MIN_CANDIDATES (8)
+#define PHYSICS_JOB_BATCH          (2)
+/// Capsule queries per job in level_capsule_query_batch.
+#define CAPSULE_QUERY_BATCH (32)
+
 #define KILL_PLANE (-20.0f)
 
 #define DEAD_TIME (3.0f)
 
+#define ACTOR_DRAG (PLAYER_DRAG)
+/// Props spawned around player by debug key.
+#define ACTOR_DEBUG_SPAWN_COUNT (64)
+
 struct json_value_s;
 
 #define PLAYER_IDLE 1
@@ -40,7 +58,14 @@ struct json_value_s;
 #define PLAYER_RUN  3
 #define PLAYER_FALL 4
 
-#define ANIM_FT (0.0166f)
+/// Player animation plays from baked frame cache once this many
+/// animated, skinned characters are drawn.
+#define ANIM_CACHE_SKINNED_THRESHOLD (16)
+
+/// Fixed simulation step used in deterministic mode.
+#define SIM_TICK_DT (1.0f / 60.0f)
+/// Ticks run per frame before falling behind real time.
+#define SIM_MAX_TICKS_PER_FRAME (4)
 
 enum LevelObjectType {
     LOT_NULL,
@@ -58,6 +83,7 @@ struct LevelObject {
             b32 has_geo;
             b32 has_col;
 
+            struct CollisionSDF* sdf;
         } t_static;
         struct LevelObjectResize {
             Model   geo;
@@ -71,18 +97,103 @@ struct LevelObject {
             Vector3 size;
             b32 geo_from_state;
             b32 col_from_state;
+            /// Index into platform_batches when geo is from state.
+            u32 geo_batch;
         } t_resize;
     };
+
+    struct CollisionMesh* collider;
+    b32    collider_from_state;
+    Matrix collider_transform;
+    Matrix collider_inverse;
+
+    /// Geo bounds in model space, taken once at load.
+    BoundingBox draw_local_bounds;
+    /// Geo bounds in world space, used for frustum culling.
+    BoundingBox draw_bounds;
 };
 struct Level {
     struct LevelObject* objects;
     usize object_count;
     Vector3 level_finish;
+
+    struct LevelBVH bvh;
+    /// Geo of every static object, drawn instead of the objects themselves.
+    struct StaticGeometry static_geo;
+    /// Counters of the game instance that owns level, every level query counts into it.
+    struct PhysicsStats* stats;
 };
 
+/// One instance batch per shared platform model.
+#define PLATFORM_BATCH_COUNT (2)
+
 #define RESIZE_TIME (0.2f)
 #define RESIZE_ON_TIME (1.4f)
 
+/// Mutable simulation state packed into one buffer.
+/// Restoring never touches assets, disk or GPU.
+struct GameSnapshot {
+    u8*   data;
+    usize size;
+    usize capacity;
+};
+
+/// Copy of everything scene_game_draw reads from simulation state.
+/// Written at the end of an update, then drawn while next update
+/// simulates, so drawing never touches state a tick is writing to.
+struct DrawSnapshot {
+    Camera3D camera;
+
+    Transform player_transform;
+    Vector3   player_velocity;
+    struct Capsule player_capsule;
+    b32 player_hit;
+    b32 player_dead;
+    b32 player_won;
+#if defined(DEBUG)
+    b32 player_ground[4];
+    struct CollisionResult player_last_collision;
+#endif
+
+    f32 resize_allowed_timer;
+    f32 dead_timer;
+    f32 won_timer;
+
+    /// Indexed by level object, only resize objects change between ticks.
+    Matrix*      object_transforms;
+    BoundingBox* object_bounds;
+    u32 object_count;
+    u32 object_capacity;
+
+    Vector3* actor_positions;
+    f32*     actor_radius;
+    f32*     actor_height;
+    u8*      actor_kind;
+    u32 actor_count;
+    u32 actor_capacity;
+    u32 player_actor;
+    u32 actor_pair_count;
+    u32 actor_contact_count;
+
+    /// Animated, skinned characters drawn, physics actors are not animated.
+    u32 skinned_count;
+    /// Sampled player pose, -1 animation if player has no pose.
+    Transform* pose;
+    u32 bone_count;
+    int animation;
+    int animation_frame;
+
+    f32 capsule_cache_hit_rate;
+    f32 ground_cache_hit_rate;
+    u32 bvh_node_count;
+    f32 bvh_cost_ratio;
+    u64 bvh_refit_count;
+    u64 bvh_rebuild_count;
+    u32 rewind_entry_count;
+    usize rewind_bytes_used;
+    struct PhysicsCounters physics_counters;
+};
+
 struct SceneGame {
     struct Player {
         Transform transform;
@@ -98,6 +209,7 @@ struct SceneGame {
             Vector2 move;
             Vector2 rotation;
             b32 resize_hold;
+            b32 rewind_hold;
         } input;
 
         Vector2 camera_rotation;
@@ -132,12 +244,34 @@ struct SceneGame {
 
     Model platform1;
     Model platform2;
-
-    ModelAnimation* player_anim;
-    int player_anim_count;
-
-    u32 anim_frame;
-    f32 anim_timer;
+    struct CollisionMesh platform1_collider;
+    struct CollisionMesh platform2_collider;
+
+    /// Resize objects using platform1 and platform2 are drawn through these.
+    struct InstanceBatch platform_batches[PLATFORM_BATCH_COUNT];
+    /// Invalid if instancing is not available.
+    Shader shader_instanced;
+
+    /// Compressed, raylib's animations are unloaded after packing.
+    struct AnimClip* player_clips;
+    u32 player_clip_count;
+    struct SkinModel player_skin;
+    /// Every player clip pre-skinned, trades memory for skinning time.
+    /// Baked on first use, never in builds with one skinned character.
+    struct SkinCache player_cache;
+    b32 player_cache_baked;
+    b32 anim_cache_forced;
+    b32 anim_cache_active;
+    /// Skins player in vertex shader when GL supports it.
+    struct SkinGPU player_gpu_skin;
+    b32 gpu_skinning;
+
+    /// Player pose, advanced once per update by scene_game_animate.
+    struct AnimSampler player_sampler;
+
+    /// Front is drawn, back is written by thread running the update.
+    struct DrawSnapshot draw_snapshots[2];
+    u32 draw_front;
 
     f32 resize_allowed_timer;
     b32 resize_banned;
@@ -153,14 +287,112 @@ struct SceneGame {
     u32 current_level;
     struct Level level;
 
+    struct CapsuleCache   capsule_cache;
+    struct CollisionCache ground_cache;
+    struct CacheCounters  capsule_cache_counters;
+    struct CacheCounters  ground_cache_counters;
+
+    struct ActorPool actors;
+    // NOTE(alicia): kinematic actor that follows player so
+    // actors get pushed around by them.
+    u32 player_actor;
+
+    /// Taken after level load, dying restores it instead of reloading scene.
+    struct GameSnapshot checkpoint;
+    /// Ticks step backwards through this while rewind is held.
+    struct Rewind rewind;
+
+    /// Physics work done during last update.
+    struct PhysicsCounters physics_counters;
+    /// Written by this instance's level queries only.
+    struct PhysicsStats physics_stats;
+
+    /// 3D pass resolution, GUI is always drawn at window size.
+    struct DynamicResolution resolution;
+
+    /// Static chunks and resize objects drawn and frustum culled last frame.
+    u32 draw_count;
+    u32 cull_count;
+    u32 draw_call_count;
+
+    b32 use_sdf;
+    b32 bake_sdf;
+
     int current_animation;
 
     Camera3D camera;
 };
 
+/// Side effects of a tick, applied by scene_game_events.
+enum GameEvent {
+    GAME_EVENT_JUMP    = (1 << 0),
+    GAME_EVENT_RESIZE  = (1 << 1),
+    GAME_EVENT_DIED    = (1 << 2),
+    /// Player finished level and has celebrated long enough to leave it.
+    GAME_EVENT_EXIT    = (1 << 3),
+    /// Player has been dead long enough, checkpoint was restored.
+    GAME_EVENT_RESPAWN = (1 << 4),
+    /// Tick stepped back through rewind history instead of simulating.
+    GAME_EVENT_REWIND  = (1 << 5),
+};
+
 void scene_game_load( struct SceneGame* out_state );
 void scene_game_unload( struct SceneGame* state );
-void scene_game_update( f32 dt, struct SceneGame* state );
+/// Copy of source's simulation state that can be ticked independently.
+/// Shares models, audio, colliders and SDFs with source,
+/// source must outlive it.
+void scene_game_instance_create(
+    const struct SceneGame* source, struct SceneGame* out_instance );
+void scene_game_instance_destroy( struct SceneGame* instance );
+/// Main thread half of an update, samples input for next tick and
+/// handles debug keys. Ticks must not be running while this is called.
+void scene_game_update( f32 dt, struct SceneGame* state, struct Input* out_input );
+/// Grab mouse and sample input for next tick.
+void scene_game_poll( struct SceneGame* state, struct Input* out_input );
+/// Advance simulation by dt with given input. Returns GameEvent flags.
+/// Reads no input, time or globals, safe to run on any thread
+/// as long as each state is ticked by one thread at a time.
+u32  scene_game_tick( f32 dt, struct SceneGame* state, const struct Input* input );
+/// Play sounds, update music and change scene for events of last ticks.
+void scene_game_events( struct SceneGame* state, u32 events );
+/// Advance player animation by frame time. Runs after the update's
+/// ticks on same thread, player is skinned from draw snapshot's pose.
+void scene_game_animate( f32 dt, struct SceneGame* state );
+/// Copy what scene_game_draw needs into snapshot, arrays grow as needed.
+void scene_game_draw_snapshot_write(
+    const struct SceneGame* state, struct DrawSnapshot* out_snapshot );
+void scene_game_draw_snapshot_free( struct DrawSnapshot* snapshot );
+/// Snapshot drawn by scene_game_draw.
+struct DrawSnapshot* scene_game_draw_front( struct SceneGame* state );
+/// Snapshot written by thread running the update.
+struct DrawSnapshot* scene_game_draw_back( struct SceneGame* state );
+/// Copy player, camera, resize state, level BVH and actors into snapshot.
+/// Snapshot buffer grows as needed and is reused across calls.
+void scene_game_snapshot_take( const struct SceneGame* state, struct GameSnapshot* snapshot );
+/// Snapshot must come from same level as state. Returns false and leaves
+/// state untouched if snapshot's size or counts don't match level.
+b32  scene_game_snapshot_restore(
+    struct SceneGame* state, const struct GameSnapshot* snapshot );
+void scene_game_snapshot_free( struct GameSnapshot* snapshot );
+/// FNV-1a hash of simulation state, used to detect replay divergence.
+u64  scene_game_hash( const struct SceneGame* state );
+/// Draws front draw snapshot, only reads state that ticks never write.
 void scene_game_draw( f32 dt, struct SceneGame* state );
 
+struct CollisionResult level_capsule_query(
+    struct Level* level, Vector3 cap_start, Vector3 cap_end, f32 radius,
+    b32 use_sdf, u32* out_object );
+/// Run many capsule queries across job system workers.
+/// opt_out_objects receives hit object per query.
+void level_capsule_query_batch(
+    struct Level* level, const struct CapsuleQuery* queries, u32 count,
+    b32 use_sdf, struct CollisionResult* out_results, u32* opt_out_objects );
+/// Integrate actors, collide them with level then with each other.
+void level_actors_step(
+    struct Level* level, struct ActorPool* actors, b32 use_sdf, f32 dt );
+/// Cast ray straight down from origin, nearest hit within max_distance.
+RayCollision level_ground_probe(
+    struct Level* level, Vector3 origin, f32 max_distance,
+    u32* out_object, i32* out_triangle );
+
 #endif /* header guard */
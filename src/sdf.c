@@ -0,0 +1,442 @@
+/**
+ * @file   sdf.c
+ * @brief  Signed distance field collision.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 18, 2026
+*/
+#include "sdf.h"
+#include "mathex.h"
+// IWYU pragma: begin_keep
+#include <string.h>
+// IWYU pragma: end_keep
+
+struct SDFFileHeader {
+    u32 magic;
+    u32 version;
+    f32 origin[3];
+    f32 voxel_size;
+    f32 band;
+    i32 dims[3];
+    u32 brick_count;
+};
+
+static Vector3 closest_point_on_triangle(
+    Vector3 p, Vector3 a, Vector3 b, Vector3 c
+) {
+    Vector3 ab = Vector3Subtract( b, a );
+    Vector3 ac = Vector3Subtract( c, a );
+    Vector3 ap = Vector3Subtract( p, a );
+
+    f32 d1 = Vector3DotProduct( ab, ap );
+    f32 d2 = Vector3DotProduct( ac, ap );
+    if( d1 <= 0.0f && d2 <= 0.0f ) {
+        return a;
+    }
+
+    Vector3 bp = Vector3Subtract( p, b );
+    f32 d3 = Vector3DotProduct( ab, bp );
+    f32 d4 = Vector3DotProduct( ac, bp );
+    if( d3 >= 0.0f && d4 <= d3 ) {
+        return b;
+    }
+
+    f32 vc = d1 * d4 - d3 * d2;
+    if( vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f ) {
+        f32 v = d1 / ( d1 - d3 );
+        return Vector3Add( a, Vector3Scale( ab, v ) );
+    }
+
+    Vector3 cp = Vector3Subtract( p, c );
+    f32 d5 = Vector3DotProduct( ab, cp );
+    f32 d6 = Vector3DotProduct( ac, cp );
+    if( d6 >= 0.0f && d5 <= d6 ) {
+        return c;
+    }
+
+    f32 vb = d5 * d2 - d1 * d6;
+    if( vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f ) {
+        f32 w = d2 / ( d2 - d6 );
+        return Vector3Add( a, Vector3Scale( ac, w ) );
+    }
+
+    f32 va = d3 * d6 - d5 * d4;
+    if( va <= 0.0f && ( d4 - d3 ) >= 0.0f && ( d5 - d6 ) >= 0.0f ) {
+        f32 w = ( d4 - d3 ) / ( ( d4 - d3 ) + ( d5 - d6 ) );
+        return Vector3Add( b, Vector3Scale( Vector3Subtract( c, b ), w ) );
+    }
+
+    f32 denom = 1.0f / ( va + vb + vc );
+    f32 v = vb * denom;
+    f32 w = vc * denom;
+    return Vector3Add( a, Vector3Add( Vector3Scale( ab, v ), Vector3Scale( ac, w ) ) );
+}
+
+static f32 sdf_mesh_distance(
+    const struct CollisionMesh* mesh, const u32* triangles, u32 triangle_count,
+    Vector3 point, f32 band
+) {
+    f32 best_distance_sqr = band * band;
+    f32 best_alignment    = 0.0f;
+    f32 sign              = 1.0f;
+
+    for( u32 i = 0; i < triangle_count; ++i ) {
+        Vector3 p0, p1, p2;
+        collision_mesh_triangle( mesh, triangles[i], &p0, &p1, &p2 );
+
+        Vector3 closest = closest_point_on_triangle( point, p0, p1, p2 );
+        Vector3 delta   = Vector3Subtract( point, closest );
+        f32 distance_sqr = Vector3DotProduct( delta, delta );
+        if( distance_sqr > best_distance_sqr + EPSILON ) {
+            continue;
+        }
+
+        Vector3 normal = Vector3Normalize(
+            Vector3CrossProduct( Vector3Subtract( p1, p0 ), Vector3Subtract( p2, p0 ) ) );
+        f32 alignment = Vector3DotProduct( Vector3Normalize( delta ), normal );
+
+        // NOTE(alicia): at shared edges and vertices several triangles
+        // are equally close, the one facing the point decides the sign.
+        if(
+            distance_sqr < best_distance_sqr - EPSILON ||
+            absf( alignment ) > absf( best_alignment )
+        ) {
+            best_distance_sqr = fminf( distance_sqr, best_distance_sqr );
+            best_alignment    = alignment;
+            sign              = alignment < 0.0f ? -1.0f : 1.0f;
+        }
+    }
+
+    return sqrtf( best_distance_sqr ) * sign;
+}
+
+/// inside if most axis rays first hit a triangle from behind.
+static b32 sdf_mesh_inside( const struct CollisionMesh* mesh, Vector3 point ) {
+    Vector3 directions[3] = {
+        v3( 1.0f, 0.0f, 0.0f ), v3( 0.0f, 1.0f, 0.0f ), v3( 0.0f, 0.0f, 1.0f ) };
+    BoundingBox bounds = collision_mesh_bounds( mesh );
+    f32 max_distance   =
+        Vector3Distance( point, bounds.min ) + Vector3Distance( bounds.min, bounds.max );
+
+    u32 votes = 0;
+    for( u32 i = 0; i < 3; ++i ) {
+        Ray ray;
+        ray.position  = point;
+        ray.direction = directions[i];
+        RayCollision hit = collision_mesh_ray(
+            ray, max_distance, mesh, MatrixIdentity(), NULL, NULL );
+        if( hit.hit && Vector3DotProduct( hit.normal, ray.direction ) > 0.0f ) {
+            votes++;
+        }
+    }
+    return votes >= 2;
+}
+
+static u8 sdf_quantize( f32 distance, f32 band ) {
+    f32 t = Clamp( distance / band, -1.0f, 1.0f ) * 0.5f + 0.5f;
+    return (u8)( t * 255.0f + 0.5f );
+}
+static f32 sdf_dequantize( u8 value, f32 band ) {
+    return ( ( (f32)value / 255.0f ) * 2.0f - 1.0f ) * band;
+}
+
+b32 collision_sdf_bake( const struct CollisionMesh* mesh, struct CollisionSDF* out_sdf ) {
+    memset( out_sdf, 0, sizeof(*out_sdf) );
+    if( !mesh->triangle_count ) {
+        return false;
+    }
+
+    out_sdf->voxel_size = SDF_VOXEL_SIZE;
+    out_sdf->band       = SDF_BAND;
+
+    f32 brick_size = out_sdf->voxel_size * SDF_BRICK_CELLS;
+
+    BoundingBox bounds = collision_mesh_bounds( mesh );
+    bounds.min = Vector3SubtractValue( bounds.min, out_sdf->band );
+    bounds.max = Vector3AddValue( bounds.max, out_sdf->band );
+
+    out_sdf->origin = bounds.min;
+    Vector3 extent  = Vector3Subtract( bounds.max, bounds.min );
+    out_sdf->dims[0] = (i32)ceilf( extent.x / brick_size );
+    out_sdf->dims[1] = (i32)ceilf( extent.y / brick_size );
+    out_sdf->dims[2] = (i32)ceilf( extent.z / brick_size );
+
+    usize cell_count = (usize)out_sdf->dims[0] * out_sdf->dims[1] * out_sdf->dims[2];
+    out_sdf->brick_index = MemAlloc( sizeof(i32) * cell_count );
+
+    u32* triangles    = MemAlloc( sizeof(u32) * mesh->triangle_count );
+    u32  brick_cap    = 0;
+
+    for( i32 z = 0; z < out_sdf->dims[2]; ++z ) {
+        for( i32 y = 0; y < out_sdf->dims[1]; ++y ) {
+            for( i32 x = 0; x < out_sdf->dims[0]; ++x ) {
+                usize cell = ( (usize)z * out_sdf->dims[1] + y ) * out_sdf->dims[0] + x;
+                out_sdf->brick_index[cell] = SDF_BRICK_OUTSIDE;
+
+                Vector3 brick_min = Vector3Add(
+                    out_sdf->origin,
+                    Vector3Scale( v3( x, y, z ), brick_size ) );
+
+                BoundingBox query;
+                query.min = Vector3SubtractValue( brick_min, out_sdf->band );
+                query.max = Vector3AddValue( brick_min, brick_size + out_sdf->band );
+
+                u32 triangle_count = collision_mesh_query_box(
+                    mesh, query, NULL, triangles, mesh->triangle_count );
+                if( !triangle_count ) {
+                    // NOTE(alicia): bricks far from any triangle
+                    // still need a sign, otherwise the inside of
+                    // thick geometry reads as empty space.
+                    Vector3 center = Vector3AddValue( brick_min, brick_size * 0.5f );
+                    if( sdf_mesh_inside( mesh, center ) ) {
+                        out_sdf->brick_index[cell] = SDF_BRICK_INSIDE;
+                    }
+                    continue;
+                }
+
+                if( out_sdf->brick_count == brick_cap ) {
+                    brick_cap = brick_cap ? brick_cap * 2 : 64;
+                    out_sdf->bricks = MemRealloc(
+                        out_sdf->bricks, brick_cap * SDF_BRICK_SAMPLE_COUNT );
+                }
+
+                u8* brick = out_sdf->bricks +
+                    (usize)out_sdf->brick_count * SDF_BRICK_SAMPLE_COUNT;
+                b32 near_surface = false;
+
+                for( u32 k = 0; k < SDF_BRICK_SAMPLES; ++k ) {
+                    for( u32 j = 0; j < SDF_BRICK_SAMPLES; ++j ) {
+                        for( u32 i = 0; i < SDF_BRICK_SAMPLES; ++i ) {
+                            Vector3 point = Vector3Add(
+                                brick_min,
+                                Vector3Scale( v3( i, j, k ), out_sdf->voxel_size ) );
+                            f32 distance = sdf_mesh_distance(
+                                mesh, triangles, triangle_count, point, out_sdf->band );
+                            near_surface |= absf( distance ) < out_sdf->band;
+
+                            brick[( k * SDF_BRICK_SAMPLES + j ) * SDF_BRICK_SAMPLES + i] =
+                                sdf_quantize( distance, out_sdf->band );
+                        }
+                    }
+                }
+
+                if( near_surface ) {
+                    out_sdf->brick_index[cell] = out_sdf->brick_count++;
+                } else if( brick[0] < 128 ) {
+                    out_sdf->brick_index[cell] = SDF_BRICK_INSIDE;
+                }
+            }
+        }
+    }
+
+    MemFree( triangles );
+    return true;
+}
+
+b32 collision_sdf_save( const struct CollisionSDF* sdf, const char* path ) {
+    struct SDFFileHeader header;
+    memset( &header, 0, sizeof(header) );
+    header.magic       = SDF_FILE_MAGIC;
+    header.version     = SDF_FILE_VERSION;
+    header.origin[0]   = sdf->origin.x;
+    header.origin[1]   = sdf->origin.y;
+    header.origin[2]   = sdf->origin.z;
+    header.voxel_size  = sdf->voxel_size;
+    header.band        = sdf->band;
+    memcpy( header.dims, sdf->dims, sizeof(header.dims) );
+    header.brick_count = sdf->brick_count;
+
+    usize index_size = sizeof(i32) * (usize)sdf->dims[0] * sdf->dims[1] * sdf->dims[2];
+    usize brick_size = (usize)sdf->brick_count * SDF_BRICK_SAMPLE_COUNT;
+    usize size       = sizeof(header) + index_size + brick_size;
+
+    u8* buffer = MemAlloc( size );
+    memcpy( buffer, &header, sizeof(header) );
+    memcpy( buffer + sizeof(header), sdf->brick_index, index_size );
+    memcpy( buffer + sizeof(header) + index_size, sdf->bricks, brick_size );
+
+    b32 result = SaveFileData( path, buffer, size );
+    MemFree( buffer );
+    return result;
+}
+b32 collision_sdf_load( const char* path, struct CollisionSDF* out_sdf ) {
+    memset( out_sdf, 0, sizeof(*out_sdf) );
+    if( !FileExists( path ) ) {
+        return false;
+    }
+
+    int data_size = 0;
+    unsigned char* data = LoadFileData( path, &data_size );
+    if( !data ) {
+        return false;
+    }
+
+    struct SDFFileHeader header;
+    if( (usize)data_size < sizeof(header) ) {
+        UnloadFileData( data );
+        return false;
+    }
+    memcpy( &header, data, sizeof(header) );
+
+    usize index_size =
+        sizeof(i32) * (usize)header.dims[0] * header.dims[1] * header.dims[2];
+    usize brick_size = (usize)header.brick_count * SDF_BRICK_SAMPLE_COUNT;
+    if(
+        header.magic != SDF_FILE_MAGIC ||
+        header.version != SDF_FILE_VERSION ||
+        (usize)data_size != sizeof(header) + index_size + brick_size
+    ) {
+        TraceLog( LOG_WARNING, "SDF %s is invalid or out of date!", path );
+        UnloadFileData( data );
+        return false;
+    }
+
+    out_sdf->origin      = v3( header.origin[0], header.origin[1], header.origin[2] );
+    out_sdf->voxel_size  = header.voxel_size;
+    out_sdf->band        = header.band;
+    memcpy( out_sdf->dims, header.dims, sizeof(out_sdf->dims) );
+    out_sdf->brick_count = header.brick_count;
+
+    out_sdf->brick_index = MemAlloc( index_size );
+    out_sdf->bricks      = MemAlloc( brick_size ? brick_size : 1 );
+    memcpy( out_sdf->brick_index, data + sizeof(header), index_size );
+    memcpy( out_sdf->bricks, data + sizeof(header) + index_size, brick_size );
+
+    UnloadFileData( data );
+    return true;
+}
+void collision_sdf_destroy( struct CollisionSDF* sdf ) {
+    MemFree( sdf->brick_index );
+    MemFree( sdf->bricks );
+    memset( sdf, 0, sizeof(*sdf) );
+}
+usize collision_sdf_memory( const struct CollisionSDF* sdf ) {
+    return
+        sizeof(i32) * (usize)sdf->dims[0] * sdf->dims[1] * sdf->dims[2] +
+        (usize)sdf->brick_count * SDF_BRICK_SAMPLE_COUNT;
+}
+const char* collision_sdf_path( const char* mesh_path ) {
+    return TextFormat( "%s/%s.sdf",
+        GetDirectoryPath( mesh_path ), GetFileNameWithoutExt( mesh_path ) );
+}
+
+f32 collision_sdf_sample( const struct CollisionSDF* sdf, Vector3 point ) {
+    Vector3 grid = Vector3Scale(
+        Vector3Subtract( point, sdf->origin ), 1.0f / sdf->voxel_size );
+
+    i32 brick[3];
+    f32 local[3];
+    f32 coords[3] = { grid.x, grid.y, grid.z };
+    for( u32 i = 0; i < 3; ++i ) {
+        if( coords[i] < 0.0f ) {
+            return sdf->band;
+        }
+        brick[i] = (i32)( coords[i] / SDF_BRICK_CELLS );
+        if( brick[i] >= sdf->dims[i] ) {
+            return sdf->band;
+        }
+        local[i] = coords[i] - (f32)( brick[i] * SDF_BRICK_CELLS );
+    }
+
+    i32 index = sdf->brick_index[
+        ( (usize)brick[2] * sdf->dims[1] + brick[1] ) * sdf->dims[0] + brick[0] ];
+    if( index == SDF_BRICK_INSIDE ) {
+        return -sdf->band;
+    }
+    if( index < 0 ) {
+        return sdf->band;
+    }
+    const u8* samples = sdf->bricks + (usize)index * SDF_BRICK_SAMPLE_COUNT;
+
+    u32 cell[3];
+    f32 t[3];
+    for( u32 i = 0; i < 3; ++i ) {
+        f32 c = floorf( local[i] );
+        if( c > SDF_BRICK_CELLS - 1 ) {
+            c = SDF_BRICK_CELLS - 1;
+        }
+        cell[i] = (u32)c;
+        t[i]    = local[i] - c;
+    }
+
+    #define sample( x, y, z ) sdf_dequantize( samples[\
+        ( ( cell[2] + (z) ) * SDF_BRICK_SAMPLES + ( cell[1] + (y) ) ) *\
+        SDF_BRICK_SAMPLES + ( cell[0] + (x) ) ], sdf->band )
+
+    f32 x00 = Lerp( sample( 0, 0, 0 ), sample( 1, 0, 0 ), t[0] );
+    f32 x10 = Lerp( sample( 0, 1, 0 ), sample( 1, 1, 0 ), t[0] );
+    f32 x01 = Lerp( sample( 0, 0, 1 ), sample( 1, 0, 1 ), t[0] );
+    f32 x11 = Lerp( sample( 0, 1, 1 ), sample( 1, 1, 1 ), t[0] );
+
+    #undef sample
+
+    return Lerp( Lerp( x00, x10, t[1] ), Lerp( x01, x11, t[1] ), t[2] );
+}
+Vector3 collision_sdf_gradient( const struct CollisionSDF* sdf, Vector3 point ) {
+    f32 h = sdf->voxel_size * 0.5f;
+    Vector3 gradient = {
+        collision_sdf_sample( sdf, v3( point.x + h, point.y, point.z ) ) -
+        collision_sdf_sample( sdf, v3( point.x - h, point.y, point.z ) ),
+        collision_sdf_sample( sdf, v3( point.x, point.y + h, point.z ) ) -
+        collision_sdf_sample( sdf, v3( point.x, point.y - h, point.z ) ),
+        collision_sdf_sample( sdf, v3( point.x, point.y, point.z + h ) ) -
+        collision_sdf_sample( sdf, v3( point.x, point.y, point.z - h ) ),
+    };
+    return Vector3Normalize( gradient );
+}
+
+struct CollisionResult collision_sdf_capsule(
+    Vector3 cap_start, Vector3 cap_end, f32 radius,
+    const struct CollisionSDF* sdf, Matrix transform, Matrix inverse,
+    struct PhysicsStats* stats, b32* out_saturated
+) {
+    struct CollisionResult result;
+    memset( &result, 0, sizeof(result) );
+    result.triangle = -1;
+    *out_saturated  = false;
+
+    Vector3 capsule_normal =
+        Vector3Normalize( Vector3Subtract( cap_end, cap_start ) );
+    Vector3 line_end_offset = Vector3Scale( capsule_normal, radius );
+
+    Vector3 a = Vector3Transform( Vector3Add( cap_start, line_end_offset ), inverse );
+    Vector3 b = Vector3Transform( Vector3Subtract( cap_end, line_end_offset ), inverse );
+
+    f32     best_distance = sdf->band;
+    Vector3 best_point    = a;
+    for( u32 i = 0; i < SDF_CAPSULE_SAMPLES; ++i ) {
+        Vector3 point = v3_lerp( a, b, (f32)i / (f32)( SDF_CAPSULE_SAMPLES - 1 ) );
+        f32 distance  = collision_sdf_sample( sdf, point );
+        // NOTE(alicia): past the band only the sign is known,
+        // penetration depth and normal would be wrong.
+        if( distance <= -sdf->band ) {
+            *out_saturated = true;
+            return result;
+        }
+        if( distance < best_distance ) {
+            best_distance = distance;
+            best_point    = point;
+        }
+    }
+
+    // NOTE(alicia): band distance only means at least band away,
+    // that says nothing about capsules wider than the band.
+    if( best_distance >= sdf->band && radius >= sdf->band ) {
+        *out_saturated = true;
+        return result;
+    }
+    if( best_distance >= radius ) {
+        return result;
+    }
+
+    Vector3 normal = collision_sdf_gradient( sdf, best_point );
+    physics_counter_add( stats, PHYSICS_COUNTER_HITS, 1 );
+
+    result.hit      = true;
+    result.distance = radius - best_distance;
+    result.normal   = v3_transform_normal( normal, inverse );
+    result.point    = Vector3Transform(
+        Vector3Subtract( best_point, Vector3Scale( normal, best_distance ) ),
+        transform );
+
+    return result;
+}
@@ -0,0 +1,64 @@
+#if !defined(SDF_H)
+#define SDF_H
+/**
+ * @file   sdf.h
+ * @brief  Signed distance field collision.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 18, 2026
+*/
+#include "common.h"
+#include "physics.h"
+
+#define SDF_BRICK_CELLS   (8)
+#define SDF_BRICK_SAMPLES (SDF_BRICK_CELLS + 1)
+#define SDF_BRICK_SAMPLE_COUNT\
+    (SDF_BRICK_SAMPLES * SDF_BRICK_SAMPLES * SDF_BRICK_SAMPLES)
+
+#define SDF_VOXEL_SIZE (0.125f)
+#define SDF_BAND       (SDF_VOXEL_SIZE * 4.0f)
+
+#define SDF_CAPSULE_SAMPLES (5)
+
+#define SDF_FILE_MAGIC   (0x46445347) // GSDF
+#define SDF_FILE_VERSION (2)
+
+/// Brick index of a brick that is not stored, all of it is further
+/// than band outside or inside the surface.
+#define SDF_BRICK_OUTSIDE (-1)
+#define SDF_BRICK_INSIDE  (-2)
+
+/// Sparse brick grid. Only bricks within band of a surface are stored,
+/// everything else reads as band or -band distance.
+/// Samples are quantized to 8 bits over [-band, band].
+struct CollisionSDF {
+    Vector3 origin;
+    f32     voxel_size;
+    f32     band;
+    i32     dims[3];
+
+    i32* brick_index;
+    u32  brick_count;
+    u8*  bricks;
+};
+
+b32  collision_sdf_bake( const struct CollisionMesh* mesh, struct CollisionSDF* out_sdf );
+b32  collision_sdf_save( const struct CollisionSDF* sdf, const char* path );
+b32  collision_sdf_load( const char* path, struct CollisionSDF* out_sdf );
+void collision_sdf_destroy( struct CollisionSDF* sdf );
+usize collision_sdf_memory( const struct CollisionSDF* sdf );
+/// path of baked sdf for collision mesh at mesh_path.
+/// result is a TextFormat buffer.
+const char* collision_sdf_path( const char* mesh_path );
+
+f32     collision_sdf_sample( const struct CollisionSDF* sdf, Vector3 point );
+Vector3 collision_sdf_gradient( const struct CollisionSDF* sdf, Vector3 point );
+
+/// transform must be rigid, sdf distances are not rescaled.
+/// out_saturated is set when a sample was clamped to the band
+/// so the result can't be trusted and the mesh should be queried instead.
+struct CollisionResult collision_sdf_capsule(
+    Vector3 cap_start, Vector3 cap_end, f32 radius,
+    const struct CollisionSDF* sdf, Matrix transform, Matrix inverse,
+    struct PhysicsStats* stats, b32* out_saturated );
+
+#endif /* header guard */
@@ -0,0 +1,580 @@
+/**
+ * @file   skin.c
+ * @brief  CPU skinning.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 19, 2026
+*/
+#include "skin.h"
+#include "mathex.h"
+#include "rlgl.h"
+// IWYU pragma: begin_keep
+#include <string.h>
+// IWYU pragma: end_keep
+#if defined(__x86_64__) || defined(__SSE__)
+    #include <xmmintrin.h>
+    #define SKIN_SSE
+#endif
+
+b32 skin_model_create( Model model, struct SkinModel* out_skin ) {
+    memset( out_skin, 0, sizeof(*out_skin) );
+    if( !model.boneCount || !model.meshCount ) {
+        return false;
+    }
+
+    out_skin->bone_count = (u32)model.boneCount;
+    out_skin->palette    =
+        MemAlloc( sizeof(f32) * SKIN_PALETTE_STRIDE * out_skin->bone_count );
+    out_skin->mesh_count = (u32)model.meshCount;
+    out_skin->meshes     = MemAlloc( sizeof(struct SkinMesh) * out_skin->mesh_count );
+
+    b32 any_skinned = false;
+    for( u32 i = 0; i < out_skin->mesh_count; ++i ) {
+        Mesh mesh = model.meshes[i];
+        struct SkinMesh* skin_mesh = out_skin->meshes + i;
+        if( !mesh.boneIds || !mesh.boneWeights || !mesh.animVertices ) {
+            continue;
+        }
+
+        u32 count = (u32)mesh.vertexCount;
+        skin_mesh->vertex_count = count;
+        skin_mesh->positions    = MemAlloc( sizeof(f32) * 4 * count );
+        skin_mesh->bone_ids     = MemAlloc( sizeof(u8) * SKIN_BONES_PER_VERTEX * count );
+        skin_mesh->bone_weights =
+            MemAlloc( sizeof(f32) * SKIN_BONES_PER_VERTEX * count );
+        if( mesh.normals && mesh.animNormals ) {
+            skin_mesh->normals = MemAlloc( sizeof(f32) * 4 * count );
+        }
+
+        for( u32 v = 0; v < count; ++v ) {
+            memcpy( skin_mesh->positions + v * 4, mesh.vertices + v * 3, sizeof(f32) * 3 );
+            skin_mesh->positions[v * 4 + 3] = 1.0f;
+            if( skin_mesh->normals ) {
+                memcpy( skin_mesh->normals + v * 4, mesh.normals + v * 3, sizeof(f32) * 3 );
+                skin_mesh->normals[v * 4 + 3] = 0.0f;
+            }
+
+            for( u32 k = 0; k < SKIN_BONES_PER_VERTEX; ++k ) {
+                u32 index = v * SKIN_BONES_PER_VERTEX + k;
+                u8  bone  = mesh.boneIds[index];
+                f32 weight = mesh.boneWeights[index];
+                // NOTE(alicia): out of range bones would read past palette.
+                if( bone >= out_skin->bone_count ) {
+                    bone   = 0;
+                    weight = 0.0f;
+                }
+                skin_mesh->bone_ids[index]     = bone;
+                skin_mesh->bone_weights[index] = weight;
+            }
+        }
+        any_skinned = true;
+    }
+
+    if( !any_skinned ) {
+        skin_model_destroy( out_skin );
+        return false;
+    }
+    return true;
+}
+void skin_model_destroy( struct SkinModel* skin ) {
+    for( u32 i = 0; i < skin->mesh_count; ++i ) {
+        struct SkinMesh* mesh = skin->meshes + i;
+        MemFree( mesh->positions );
+        MemFree( mesh->normals );
+        MemFree( mesh->bone_ids );
+        MemFree( mesh->bone_weights );
+    }
+    MemFree( skin->meshes );
+    MemFree( skin->palette );
+    memset( skin, 0, sizeof(*skin) );
+}
+
+void skin_palette_update( struct SkinModel* skin, Model model, const Transform* pose ) {
+    for( u32 bone = 0; bone < skin->bone_count; ++bone ) {
+        Transform bind   = model.bindPose[bone];
+        Transform target = pose[bone];
+
+        // NOTE(alicia): same transform raylib's UpdateModelAnimation
+        // applies per vertex, v' = R * S * (v - bind) + target,
+        // folded into one affine matrix per bone.
+        Quaternion rotation = QuaternionMultiply(
+            target.rotation, QuaternionInvert( bind.rotation ) );
+        Matrix r = QuaternionToMatrix( rotation );
+
+        Vector3 r0 = v3( r.m0, r.m1, r.m2 );
+        Vector3 r1 = v3( r.m4, r.m5, r.m6 );
+        Vector3 r2 = v3( r.m8, r.m9, r.m10 );
+        Vector3 a0 = Vector3Scale( r0, target.scale.x );
+        Vector3 a1 = Vector3Scale( r1, target.scale.y );
+        Vector3 a2 = Vector3Scale( r2, target.scale.z );
+
+        Vector3 moved_bind = Vector3Add( Vector3Add(
+            Vector3Scale( a0, bind.translation.x ),
+            Vector3Scale( a1, bind.translation.y ) ),
+            Vector3Scale( a2, bind.translation.z ) );
+        Vector3 offset = Vector3Subtract( target.translation, moved_bind );
+
+        f32* out = skin->palette + bone * SKIN_PALETTE_STRIDE;
+        Vector3 columns[7] = { a0, a1, a2, offset, r0, r1, r2 };
+        for( u32 i = 0; i < 7; ++i ) {
+            out[i * 4 + 0] = columns[i].x;
+            out[i * 4 + 1] = columns[i].y;
+            out[i * 4 + 2] = columns[i].z;
+            out[i * 4 + 3] = 0.0f;
+        }
+    }
+}
+
+static void skin_mesh_apply(
+    const struct SkinMesh* skin_mesh, const f32* palette,
+    f32* out_positions, f32* out_normals
+) {
+    for( u32 v = 0; v < skin_mesh->vertex_count; ++v ) {
+        const u8*  ids     = skin_mesh->bone_ids     + v * SKIN_BONES_PER_VERTEX;
+        const f32* weights = skin_mesh->bone_weights + v * SKIN_BONES_PER_VERTEX;
+        const f32* position = skin_mesh->positions + v * 4;
+
+#if defined(SKIN_SSE)
+        __m128 c0 = _mm_setzero_ps();
+        __m128 c1 = _mm_setzero_ps();
+        __m128 c2 = _mm_setzero_ps();
+        __m128 c3 = _mm_setzero_ps();
+        __m128 n0 = _mm_setzero_ps();
+        __m128 n1 = _mm_setzero_ps();
+        __m128 n2 = _mm_setzero_ps();
+        for( u32 k = 0; k < SKIN_BONES_PER_VERTEX; ++k ) {
+            if( weights[k] == 0.0f ) {
+                continue;
+            }
+            const f32* bone = palette + ids[k] * SKIN_PALETTE_STRIDE;
+            __m128 w = _mm_set1_ps( weights[k] );
+            c0 = _mm_add_ps( c0, _mm_mul_ps( w, _mm_loadu_ps( bone + 0 ) ) );
+            c1 = _mm_add_ps( c1, _mm_mul_ps( w, _mm_loadu_ps( bone + 4 ) ) );
+            c2 = _mm_add_ps( c2, _mm_mul_ps( w, _mm_loadu_ps( bone + 8 ) ) );
+            c3 = _mm_add_ps( c3, _mm_mul_ps( w, _mm_loadu_ps( bone + 12 ) ) );
+            if( out_normals ) {
+                n0 = _mm_add_ps( n0, _mm_mul_ps( w, _mm_loadu_ps( bone + 16 ) ) );
+                n1 = _mm_add_ps( n1, _mm_mul_ps( w, _mm_loadu_ps( bone + 20 ) ) );
+                n2 = _mm_add_ps( n2, _mm_mul_ps( w, _mm_loadu_ps( bone + 24 ) ) );
+            }
+        }
+
+        // NOTE(alicia): columns are blended so each vertex is three
+        // broadcasts and multiply-adds, no horizontal sums.
+        __m128 p = _mm_add_ps( c3, _mm_add_ps(
+            _mm_mul_ps( c0, _mm_set1_ps( position[0] ) ), _mm_add_ps(
+            _mm_mul_ps( c1, _mm_set1_ps( position[1] ) ),
+            _mm_mul_ps( c2, _mm_set1_ps( position[2] ) ) ) ) );
+        f32 result[4];
+        _mm_storeu_ps( result, p );
+        memcpy( out_positions + v * 3, result, sizeof(f32) * 3 );
+
+        if( out_normals ) {
+            const f32* normal = skin_mesh->normals + v * 4;
+            __m128 n = _mm_add_ps(
+                _mm_mul_ps( n0, _mm_set1_ps( normal[0] ) ), _mm_add_ps(
+                _mm_mul_ps( n1, _mm_set1_ps( normal[1] ) ),
+                _mm_mul_ps( n2, _mm_set1_ps( normal[2] ) ) ) );
+            _mm_storeu_ps( result, n );
+            memcpy( out_normals + v * 3, result, sizeof(f32) * 3 );
+        }
+#else
+        f32 m[SKIN_PALETTE_STRIDE];
+        memset( m, 0, sizeof(m) );
+        for( u32 k = 0; k < SKIN_BONES_PER_VERTEX; ++k ) {
+            if( weights[k] == 0.0f ) {
+                continue;
+            }
+            const f32* bone = palette + ids[k] * SKIN_PALETTE_STRIDE;
+            for( u32 i = 0; i < SKIN_PALETTE_STRIDE; ++i ) {
+                m[i] += weights[k] * bone[i];
+            }
+        }
+        for( u32 i = 0; i < 3; ++i ) {
+            out_positions[v * 3 + i] =
+                m[i] * position[0] + m[4 + i] * position[1] +
+                m[8 + i] * position[2] + m[12 + i];
+        }
+        if( out_normals ) {
+            const f32* normal = skin_mesh->normals + v * 4;
+            for( u32 i = 0; i < 3; ++i ) {
+                out_normals[v * 3 + i] =
+                    m[16 + i] * normal[0] + m[20 + i] * normal[1] + m[24 + i] * normal[2];
+            }
+        }
+#endif
+    }
+}
+void skin_model_apply( struct SkinModel* skin, Model model ) {
+    for( u32 i = 0; i < skin->mesh_count; ++i ) {
+        const struct SkinMesh* skin_mesh = skin->meshes + i;
+        if( !skin_mesh->vertex_count ) {
+            continue;
+        }
+        Mesh mesh = model.meshes[i];
+        f32* out_normals = skin_mesh->normals ? mesh.animNormals : NULL;
+
+        skin_mesh_apply( skin_mesh, skin->palette, mesh.animVertices, out_normals );
+
+        // NOTE(alicia): only buffers skinning touched are uploaded,
+        // texcoords, colors and indices never change.
+        UpdateMeshBuffer(
+            mesh, 0, mesh.animVertices, sizeof(f32) * 3 * mesh.vertexCount, 0 );
+        if( out_normals ) {
+            UpdateMeshBuffer(
+                mesh, 2, mesh.animNormals, sizeof(f32) * 3 * mesh.vertexCount, 0 );
+        }
+    }
+}
+void skin_model_pose( struct SkinModel* skin, Model model, const Transform* pose ) {
+    if( !skin->mesh_count ) {
+        return;
+    }
+    skin->last_pose = NULL;
+    skin_palette_update( skin, model, pose );
+    skin_model_apply( skin, model );
+}
+void skin_model_animate(
+    struct SkinModel* skin, Model model, ModelAnimation anim, int frame
+) {
+    if( !skin->mesh_count || !anim.frameCount || (u32)anim.boneCount != skin->bone_count ) {
+        return;
+    }
+    frame %= anim.frameCount;
+    if( frame < 0 ) {
+        frame += anim.frameCount;
+    }
+
+    const Transform* pose = anim.framePoses[frame];
+    if( pose == skin->last_pose ) {
+        return;
+    }
+    skin->last_pose = pose;
+
+    skin_palette_update( skin, model, pose );
+    skin_model_apply( skin, model );
+}
+
+b32 skin_cache_bake(
+    struct SkinModel* skin, Model model,
+    const struct AnimClip* clips, u32 clip_count, struct SkinCache* out_cache
+) {
+    memset( out_cache, 0, sizeof(*out_cache) );
+    out_cache->last_frame = U32_MAX;
+    if( !skin->mesh_count || !clip_count ) {
+        return false;
+    }
+
+    out_cache->clip_count       = clip_count;
+    out_cache->clip_first_frame = MemAlloc( sizeof(u32) * clip_count );
+    out_cache->clip_frame_count = MemAlloc( sizeof(u32) * clip_count );
+    for( u32 i = 0; i < clip_count; ++i ) {
+        out_cache->clip_first_frame[i] = out_cache->frame_count;
+        out_cache->clip_frame_count[i] = 0;
+        if( clips[i].bone_count == skin->bone_count && clips[i].frame_count ) {
+            out_cache->clip_frame_count[i] = clips[i].frame_count;
+            out_cache->frame_count        += clips[i].frame_count;
+        }
+    }
+    if( !out_cache->frame_count ) {
+        skin_cache_destroy( out_cache );
+        return false;
+    }
+
+    Transform* pose = MemAlloc( sizeof(Transform) * skin->bone_count );
+    out_cache->mesh_count = skin->mesh_count;
+    out_cache->meshes =
+        MemAlloc( sizeof(struct SkinCacheMesh) * out_cache->mesh_count );
+    memset( out_cache->meshes, 0, sizeof(struct SkinCacheMesh) * out_cache->mesh_count );
+
+    for( u32 mesh_index = 0; mesh_index < skin->mesh_count; ++mesh_index ) {
+        const struct SkinMesh* skin_mesh  = skin->meshes + mesh_index;
+        struct SkinCacheMesh*  cache_mesh = out_cache->meshes + mesh_index;
+        u32 vertex_count = skin_mesh->vertex_count;
+        if( !vertex_count ) {
+            continue;
+        }
+        cache_mesh->vertex_count = vertex_count;
+
+        // NOTE(alicia): all frames are skinned first so
+        // quantization range covers every pose of mesh.
+        usize stride = (usize)vertex_count * 3;
+        f32* positions = MemAlloc( sizeof(f32) * stride * out_cache->frame_count );
+        f32* normals   = NULL;
+        if( skin_mesh->normals ) {
+            normals = MemAlloc( sizeof(f32) * stride * out_cache->frame_count );
+        }
+
+        for( u32 clip = 0; clip < clip_count; ++clip ) {
+            for( u32 frame = 0; frame < out_cache->clip_frame_count[clip]; ++frame ) {
+                usize at = (usize)( out_cache->clip_first_frame[clip] + frame ) * stride;
+                anim_clip_sample( clips + clip, (f32)frame / ANIM_FRAME_RATE, pose );
+                skin_palette_update( skin, model, pose );
+                skin_mesh_apply(
+                    skin_mesh, skin->palette,
+                    positions + at, normals ? normals + at : NULL );
+            }
+        }
+        // NOTE(alicia): palette no longer matches last_pose.
+        skin->last_pose = NULL;
+
+        usize total = stride * out_cache->frame_count;
+        Vector3 min = v3( positions[0], positions[1], positions[2] );
+        Vector3 max = min;
+        for( usize i = 0; i < total; i += 3 ) {
+            Vector3 position = v3( positions[i], positions[i + 1], positions[i + 2] );
+            min = Vector3Min( min, position );
+            max = Vector3Max( max, position );
+        }
+        Vector3 extent = Vector3Subtract( max, min );
+        cache_mesh->min   = min;
+        cache_mesh->scale = Vector3Scale( extent, 1.0f / (f32)U16_MAX );
+
+        Vector3 inverse_scale = v3(
+            extent.x > 0.0f ? (f32)U16_MAX / extent.x : 0.0f,
+            extent.y > 0.0f ? (f32)U16_MAX / extent.y : 0.0f,
+            extent.z > 0.0f ? (f32)U16_MAX / extent.z : 0.0f );
+
+        cache_mesh->positions = MemAlloc( sizeof(u16) * total );
+        for( usize i = 0; i < total; i += 3 ) {
+            cache_mesh->positions[i + 0] =
+                (u16)( ( positions[i + 0] - min.x ) * inverse_scale.x + 0.5f );
+            cache_mesh->positions[i + 1] =
+                (u16)( ( positions[i + 1] - min.y ) * inverse_scale.y + 0.5f );
+            cache_mesh->positions[i + 2] =
+                (u16)( ( positions[i + 2] - min.z ) * inverse_scale.z + 0.5f );
+        }
+        if( normals ) {
+            cache_mesh->normals = MemAlloc( sizeof(i8) * total );
+            for( usize i = 0; i < total; ++i ) {
+                f32 n = Clamp( normals[i], -1.0f, 1.0f ) * 127.0f;
+                cache_mesh->normals[i] = (i8)( n < 0.0f ? n - 0.5f : n + 0.5f );
+            }
+        }
+
+        MemFree( positions );
+        MemFree( normals );
+    }
+    MemFree( pose );
+
+    return true;
+}
+void skin_cache_destroy( struct SkinCache* cache ) {
+    for( u32 i = 0; i < cache->mesh_count; ++i ) {
+        MemFree( cache->meshes[i].positions );
+        MemFree( cache->meshes[i].normals );
+    }
+    MemFree( cache->meshes );
+    MemFree( cache->clip_first_frame );
+    MemFree( cache->clip_frame_count );
+    memset( cache, 0, sizeof(*cache) );
+    cache->last_frame = U32_MAX;
+}
+void skin_cache_play( struct SkinCache* cache, Model model, u32 clip, int frame ) {
+    if( clip >= cache->clip_count || !cache->clip_frame_count[clip] ) {
+        return;
+    }
+    u32 clip_frames = cache->clip_frame_count[clip];
+    u32 index = cache->clip_first_frame[clip] + (u32)frame % clip_frames;
+    if( index == cache->last_frame ) {
+        return;
+    }
+    cache->last_frame = index;
+
+    for( u32 mesh_index = 0; mesh_index < cache->mesh_count; ++mesh_index ) {
+        const struct SkinCacheMesh* cache_mesh = cache->meshes + mesh_index;
+        if( !cache_mesh->vertex_count ) {
+            continue;
+        }
+        Mesh  mesh  = model.meshes[mesh_index];
+        usize count = (usize)cache_mesh->vertex_count * 3;
+        usize at    = count * index;
+
+        const u16* positions = cache_mesh->positions + at;
+        for( usize i = 0; i < count; i += 3 ) {
+            mesh.animVertices[i + 0] =
+                cache_mesh->min.x + (f32)positions[i + 0] * cache_mesh->scale.x;
+            mesh.animVertices[i + 1] =
+                cache_mesh->min.y + (f32)positions[i + 1] * cache_mesh->scale.y;
+            mesh.animVertices[i + 2] =
+                cache_mesh->min.z + (f32)positions[i + 2] * cache_mesh->scale.z;
+        }
+        UpdateMeshBuffer( mesh, 0, mesh.animVertices, sizeof(f32) * count, 0 );
+
+        if( cache_mesh->normals ) {
+            const i8* normals = cache_mesh->normals + at;
+            for( usize i = 0; i < count; ++i ) {
+                mesh.animNormals[i] = (f32)normals[i] * ( 1.0f / 127.0f );
+            }
+            UpdateMeshBuffer( mesh, 2, mesh.animNormals, sizeof(f32) * count, 0 );
+        }
+    }
+}
+usize skin_cache_memory( const struct SkinCache* cache ) {
+    usize result = 0;
+    for( u32 i = 0; i < cache->mesh_count; ++i ) {
+        usize count = (usize)cache->meshes[i].vertex_count * 3 * cache->frame_count;
+        result += sizeof(u16) * count;
+        if( cache->meshes[i].normals ) {
+            result += sizeof(i8) * count;
+        }
+    }
+    return result;
+}
+usize skin_cache_raw_memory( const struct SkinCache* cache ) {
+    usize result = 0;
+    for( u32 i = 0; i < cache->mesh_count; ++i ) {
+        usize count = (usize)cache->meshes[i].vertex_count * 3 * cache->frame_count;
+        result += sizeof(f32) * count * ( cache->meshes[i].normals ? 2 : 1 );
+    }
+    return result;
+}
+
+b32 skin_gpu_create( const struct SkinModel* skin, Model model, struct SkinGPU* out_gpu ) {
+    memset( out_gpu, 0, sizeof(*out_gpu) );
+    if( !skin->mesh_count || skin->bone_count > SKIN_GPU_MAX_BONES ) {
+        return false;
+    }
+
+    int version = rlGetVersion();
+    if( version != RL_OPENGL_33 && version != RL_OPENGL_43 ) {
+        return false;
+    }
+    for( u32 i = 0; i < skin->mesh_count; ++i ) {
+        if( skin->meshes[i].vertex_count && !model.meshes[i].vaoId ) {
+            return false;
+        }
+    }
+
+    Shader shader = LoadShader( SKIN_GPU_VS_PATH, SKIN_GPU_FS_PATH );
+    if( !shader.id || shader.id == rlGetShaderIdDefault() ) {
+        TraceLog( LOG_WARNING, "Failed to load skinning shader, skinning on CPU." );
+        return false;
+    }
+    // NOTE(alicia): linker picks locations for attributes that aren't
+    // pinned, they could land on normals or tangents of mesh's VAO.
+    int bone_ids_location     = GetShaderLocationAttrib( shader, "vertexBoneIds" );
+    int bone_weights_location = GetShaderLocationAttrib( shader, "vertexBoneWeights" );
+    if(
+        bone_ids_location     != SKIN_GPU_BONE_IDS_LOCATION ||
+        bone_weights_location != SKIN_GPU_BONE_WEIGHTS_LOCATION
+    ) {
+        bone_ids_location = bone_weights_location = -1;
+    }
+    out_gpu->bone_rows_location = GetShaderLocation( shader, "boneRows" );
+    if(
+        bone_ids_location < 0 || bone_weights_location < 0 ||
+        out_gpu->bone_rows_location < 0
+    ) {
+        TraceLog( LOG_WARNING, "Skinning shader is missing inputs, skinning on CPU." );
+        UnloadShader( shader );
+        return false;
+    }
+    out_gpu->shader = shader;
+
+    out_gpu->bone_id_buffers     = MemAlloc( sizeof(u32) * skin->mesh_count );
+    out_gpu->bone_weight_buffers = MemAlloc( sizeof(u32) * skin->mesh_count );
+    out_gpu->bone_rows =
+        MemAlloc( sizeof(f32) * SKIN_GPU_BONE_STRIDE * skin->bone_count );
+    for( u32 i = 0; i < skin->mesh_count; ++i ) {
+        const struct SkinMesh* skin_mesh = skin->meshes + i;
+        out_gpu->bone_id_buffers[i]     = 0;
+        out_gpu->bone_weight_buffers[i] = 0;
+        if( !skin_mesh->vertex_count ) {
+            continue;
+        }
+
+        // NOTE(alicia): raylib doesn't upload bone data,
+        // attach it to mesh's vertex array ourselves.
+        rlEnableVertexArray( model.meshes[i].vaoId );
+        out_gpu->bone_id_buffers[i] = rlLoadVertexBuffer(
+            skin_mesh->bone_ids,
+            sizeof(u8) * SKIN_BONES_PER_VERTEX * skin_mesh->vertex_count, false );
+        rlSetVertexAttribute(
+            (u32)bone_ids_location, SKIN_BONES_PER_VERTEX, RL_UNSIGNED_BYTE, false, 0, 0 );
+        rlEnableVertexAttribute( (u32)bone_ids_location );
+
+        out_gpu->bone_weight_buffers[i] = rlLoadVertexBuffer(
+            skin_mesh->bone_weights,
+            sizeof(f32) * SKIN_BONES_PER_VERTEX * skin_mesh->vertex_count, false );
+        rlSetVertexAttribute(
+            (u32)bone_weights_location, SKIN_BONES_PER_VERTEX, RL_FLOAT, false, 0, 0 );
+        rlEnableVertexAttribute( (u32)bone_weights_location );
+        rlDisableVertexArray();
+    }
+
+    out_gpu->material_shaders = MemAlloc( sizeof(Shader) * ( model.materialCount + 1 ) );
+    for( int i = 0; i < model.materialCount; ++i ) {
+        out_gpu->material_shaders[i] = model.materials[i].shader;
+    }
+    return true;
+}
+void skin_gpu_destroy( struct SkinGPU* gpu, Model model ) {
+    if( !gpu->shader.id ) {
+        return;
+    }
+    skin_gpu_disable( gpu, model );
+    for( int i = 0; i < model.meshCount; ++i ) {
+        if( gpu->bone_id_buffers[i] ) {
+            rlUnloadVertexBuffer( gpu->bone_id_buffers[i] );
+            rlUnloadVertexBuffer( gpu->bone_weight_buffers[i] );
+        }
+    }
+    UnloadShader( gpu->shader );
+    MemFree( gpu->bone_id_buffers );
+    MemFree( gpu->bone_weight_buffers );
+    MemFree( gpu->bone_rows );
+    MemFree( gpu->material_shaders );
+    memset( gpu, 0, sizeof(*gpu) );
+}
+void skin_gpu_enable( struct SkinGPU* gpu, Model model ) {
+    if( !gpu->shader.id ) {
+        return;
+    }
+    if( !gpu->bind_pose_uploaded ) {
+        for( int i = 0; i < model.meshCount; ++i ) {
+            Mesh mesh = model.meshes[i];
+            if( gpu->bone_id_buffers[i] ) {
+                UpdateMeshBuffer(
+                    mesh, 0, mesh.vertices, sizeof(f32) * 3 * mesh.vertexCount, 0 );
+            }
+        }
+        gpu->bind_pose_uploaded = true;
+    }
+    if( gpu->enabled ) {
+        return;
+    }
+    for( int i = 0; i < model.materialCount; ++i ) {
+        model.materials[i].shader = gpu->shader;
+    }
+    gpu->enabled = true;
+}
+void skin_gpu_disable( struct SkinGPU* gpu, Model model ) {
+    gpu->bind_pose_uploaded = false;
+    if( !gpu->enabled ) {
+        return;
+    }
+    for( int i = 0; i < model.materialCount; ++i ) {
+        model.materials[i].shader = gpu->material_shaders[i];
+    }
+    gpu->enabled = false;
+}
+void skin_gpu_pose(
+    struct SkinGPU* gpu, struct SkinModel* skin, Model model, const Transform* pose
+) {
+    skin->last_pose = NULL;
+    skin_palette_update( skin, model, pose );
+
+    // NOTE(alicia): palette stores columns, shader wants rows.
+    for( u32 bone = 0; bone < skin->bone_count; ++bone ) {
+        const f32* columns = skin->palette + bone * SKIN_PALETTE_STRIDE;
+        f32* rows = gpu->bone_rows + bone * SKIN_GPU_BONE_STRIDE;
+        for( u32 row = 0; row < 3; ++row ) {
+            for( u32 column = 0; column < 4; ++column ) {
+                rows[row * 4 + column] = columns[column * 4 + row];
+            }
+        }
+    }
+    SetShaderValueV(
+        gpu->shader, gpu->bone_rows_location, gpu->bone_rows,
+        SHADER_UNIFORM_VEC4, (int)( skin->bone_count * 3 ) );
+}
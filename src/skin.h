@@ -0,0 +1,135 @@
+#if !defined(SKIN_H)
+#define SKIN_H
+/**
+ * @file   skin.h
+ * @brief  CPU skinning.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 19, 2026
+*/
+#include "common.h"
+#include "raylib.h"
+#include "anim.h"
+
+#define SKIN_GPU_VS_PATH "resources/shaders/skinned.vs"
+#define SKIN_GPU_FS_PATH "resources/shaders/textured.fs"
+/// Must match MAX_BONES in skinned.vs.
+#define SKIN_GPU_MAX_BONES (64)
+/// Pinned in skinned.vs, past raylib's default attribute locations (0-5).
+#define SKIN_GPU_BONE_IDS_LOCATION     (6)
+#define SKIN_GPU_BONE_WEIGHTS_LOCATION (7)
+/// Floats per bone uploaded to skinning shader, three rows of an affine matrix.
+#define SKIN_GPU_BONE_STRIDE (12)
+
+/// Floats per bone in palette: three linear columns and
+/// offset for positions, three rotation columns for normals.
+#define SKIN_PALETTE_STRIDE (28)
+#define SKIN_BONES_PER_VERTEX (4)
+
+/// Bind pose streams of one skinned mesh, four floats per vertex
+/// so they load straight into SSE registers.
+struct SkinMesh {
+    u32  vertex_count;
+    f32* positions;
+    /// NULL if mesh has no normals.
+    f32* normals;
+    u8*  bone_ids;
+    f32* bone_weights;
+};
+
+/// Skinning state for one model, replaces UpdateModelAnimation.
+struct SkinModel {
+    struct SkinMesh* meshes;
+    u32 mesh_count;
+
+    f32* palette;
+    u32  bone_count;
+
+    // NOTE(alicia): skipped when asked for same pose twice.
+    const Transform* last_pose;
+};
+
+/// Returns false if model has no skinned meshes.
+b32  skin_model_create( Model model, struct SkinModel* out_skin );
+void skin_model_destroy( struct SkinModel* skin );
+/// Build palette from bind pose to pose, pose is boneCount transforms.
+void skin_palette_update( struct SkinModel* skin, Model model, const Transform* pose );
+/// Skin every mesh with palette into animVertices/animNormals and upload them.
+void skin_model_apply( struct SkinModel* skin, Model model );
+/// Update palette from pose and skin model, always uploads.
+void skin_model_pose( struct SkinModel* skin, Model model, const Transform* pose );
+/// Update palette and skin model for frame of anim.
+/// Does nothing if same frame was skinned last time.
+void skin_model_animate(
+    struct SkinModel* skin, Model model, ModelAnimation anim, int frame );
+
+/// One mesh of a SkinCache, frames are stored back to back.
+struct SkinCacheMesh {
+    u32 vertex_count;
+    /// Position is min + quantized * scale.
+    Vector3 min;
+    Vector3 scale;
+    u16* positions;
+    /// Snorm, NULL if mesh has no normals.
+    i8*  normals;
+};
+/// Every frame of every clip skinned at load and quantized,
+/// playback only dequantizes and uploads.
+struct SkinCache {
+    struct SkinCacheMesh* meshes;
+    u32 mesh_count;
+
+    u32* clip_first_frame;
+    u32* clip_frame_count;
+    u32  clip_count;
+    u32  frame_count;
+
+    /// U32_MAX if nothing has been played yet.
+    u32 last_frame;
+};
+
+/// Skin every frame of clips through skin palette.
+/// Clips that don't match model skeleton are left empty.
+b32  skin_cache_bake(
+    struct SkinModel* skin, Model model,
+    const struct AnimClip* clips, u32 clip_count, struct SkinCache* out_cache );
+void skin_cache_destroy( struct SkinCache* cache );
+/// Decode frame of clip into model's animVertices/animNormals and upload them.
+/// Upload costs as much as CPU skinning's, cache only saves palette math.
+/// Does nothing if same frame was played last time.
+void skin_cache_play( struct SkinCache* cache, Model model, u32 clip, int frame );
+/// Bytes used by cache and bytes same frames would take as f32.
+usize skin_cache_memory( const struct SkinCache* cache );
+usize skin_cache_raw_memory( const struct SkinCache* cache );
+
+/// Bone palette uploaded as uniforms and applied in vertex shader,
+/// per frame CPU cost depends on bone count only.
+struct SkinGPU {
+    Shader shader;
+    int    bone_rows_location;
+
+    /// Bone id and weight VBOs per mesh, zero for meshes without skin.
+    u32* bone_id_buffers;
+    u32* bone_weight_buffers;
+    f32* bone_rows;
+
+    /// Material shaders to put back when switching to CPU skinning.
+    Shader* material_shaders;
+    b32 enabled;
+    // NOTE(alicia): shader skins bind pose, CPU skinning overwrites it.
+    b32 bind_pose_uploaded;
+};
+
+/// Returns false if GL has no GLSL 330, shader fails to load, model
+/// has too many bones or meshes have no vertex arrays. Caller keeps
+/// skinning on CPU then.
+b32  skin_gpu_create( const struct SkinModel* skin, Model model, struct SkinGPU* out_gpu );
+void skin_gpu_destroy( struct SkinGPU* gpu, Model model );
+/// Point model materials at skinning shader, uploads bind pose if needed.
+void skin_gpu_enable( struct SkinGPU* gpu, Model model );
+/// Put original material shaders back.
+void skin_gpu_disable( struct SkinGPU* gpu, Model model );
+/// Build palette from pose and upload it as shader uniforms.
+void skin_gpu_pose(
+    struct SkinGPU* gpu, struct SkinModel* skin, Model model, const Transform* pose );
+
+#endif /* header guard */
@@ -8,10 +8,19 @@
 #include "main.c"
 #include "entry.c"
 #include "mathex.c"
+#include "job.c"
 #include "gui.c"
 #include "physics.c"
+#include "sdf.c"
+#include "actor.c"
+#include "render.c"
+#include "skin.c"
+#include "anim.c"
 #include "debug.c"
 #include "sc_title.c"
 #include "sc_main.c"
 #include "sc_game.c"
+#include "replay.c"
+#include "rewind.c"
+#include "tools.c"
 
@@ -0,0 +1,899 @@
+/**
+ * @file   tools.c
+ * @brief  Command line tools.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 18, 2026
+*/
+#include "tools.h"
+#include "sc_game.h"
+#include "mathex.h"
+#include "job.h"
+#include "replay.h"
+// IWYU pragma: begin_keep
+#include <string.h>
+#include <stdio.h>
+// IWYU pragma: end_keep
+
+static u32 bench_random( u32* state ) {
+    u32 x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+static f32 bench_random_f32( u32* state ) {
+    return (f32)( bench_random( state ) >> 8 ) / (f32)( 1 << 24 );
+}
+
+struct BenchReport {
+    char text[8192];
+    usize len;
+};
+static void bench_report( struct BenchReport* report, const char* line ) {
+    TraceLog( LOG_INFO, "%s", line );
+
+    usize len = strlen( line );
+    if( report->len + len + 1 >= sizeof(report->text) ) {
+        return;
+    }
+    memcpy( report->text + report->len, line, len );
+    report->len += len;
+    report->text[report->len++] = '\n';
+    report->text[report->len]   = 0;
+}
+
+static void bench_report_counters(
+    struct BenchReport* report, const struct PhysicsStats* stats,
+    const char* label, const char* unit, u32 queries
+) {
+    struct PhysicsCounters counters = physics_stats_read( stats );
+
+    char line[256];
+    int len = snprintf( line, sizeof(line), "  %s work per %s:", label, unit );
+    for( u32 i = 0; i < PHYSICS_COUNTER_COUNT && len > 0 && len < (int)sizeof(line); ++i ) {
+        len += snprintf( line + len, sizeof(line) - len, " %.2f %s%s",
+            queries ? (f64)counters.values[i] / (f64)queries : 0.0,
+            physics_counter_name( i ), i + 1 < PHYSICS_COUNTER_COUNT ? "," : "" );
+    }
+    bench_report( report, line );
+}
+
+struct BenchCapsuleResult {
+    f64 seconds;
+    u32 hits;
+};
+static struct BenchCapsuleResult bench_capsule_queries(
+    struct Level* level, const Vector3* positions, u32 count, b32 use_sdf
+) {
+    struct BenchCapsuleResult result;
+    memset( &result, 0, sizeof(result) );
+
+    physics_stats_reset( level->stats );
+    f64 start = GetTime();
+    for( u32 i = 0; i < count; ++i ) {
+        Vector3 end = Vector3Add( positions[i], v3( 0.0f, PLAYER_CAPSULE_HEIGHT, 0.0f ) );
+        struct CollisionResult collision = level_capsule_query(
+            level, positions[i], end, PLAYER_CAPSULE_RADIUS, use_sdf, NULL );
+        result.hits += collision.hit ? 1 : 0;
+    }
+    result.seconds = GetTime() - start;
+
+    return result;
+}
+static struct BenchCapsuleResult bench_capsule_queries_jobs(
+    struct Level* level, const Vector3* positions, u32 count, b32 use_sdf
+) {
+    struct BenchCapsuleResult result;
+    memset( &result, 0, sizeof(result) );
+
+    struct CapsuleQuery*    queries = MemAlloc( sizeof(*queries) * count );
+    struct CollisionResult* results = MemAlloc( sizeof(*results) * count );
+    for( u32 i = 0; i < count; ++i ) {
+        queries[i].start  = positions[i];
+        queries[i].end    =
+            Vector3Add( positions[i], v3( 0.0f, PLAYER_CAPSULE_HEIGHT, 0.0f ) );
+        queries[i].radius = PLAYER_CAPSULE_RADIUS;
+    }
+
+    physics_stats_reset( level->stats );
+    f64 start = GetTime();
+    level_capsule_query_batch( level, queries, count, use_sdf, results, NULL );
+    result.seconds = GetTime() - start;
+
+    for( u32 i = 0; i < count; ++i ) {
+        result.hits += results[i].hit ? 1 : 0;
+    }
+
+    MemFree( results );
+    MemFree( queries );
+    return result;
+}
+
+struct BenchActorResult {
+    u32 spawned;
+    u32 remaining;
+    f64 average_ms;
+    f64 max_ms;
+    f64 average_pairs;
+    f64 average_contacts;
+};
+static struct BenchActorResult bench_actors(
+    struct Level* level, struct ActorPool* actors, u32* rng
+) {
+    struct BenchActorResult result;
+    memset( &result, 0, sizeof(result) );
+
+    BoundingBox bounds = level->bvh.nodes[0].bounds;
+    Vector3 extent     = Vector3Subtract( bounds.max, bounds.min );
+
+    // NOTE(alicia): drop actors onto level surfaces so
+    // they pile up instead of falling through empty space.
+    actor_pool_clear( actors );
+    u32 attempts = BENCH_ACTOR_COUNT * 8;
+    while( actors->count < BENCH_ACTOR_COUNT && attempts-- ) {
+        Vector3 origin = v3(
+            bounds.min.x + extent.x * bench_random_f32( rng ),
+            bounds.max.y + 1.0f,
+            bounds.min.z + extent.z * bench_random_f32( rng ) );
+
+        u32 object   = 0;
+        i32 triangle = 0;
+        RayCollision ground = level_ground_probe(
+            level, origin, extent.y + 2.0f, &object, &triangle );
+        if( !ground.hit ) {
+            continue;
+        }
+
+        Vector3 position = ground.point;
+        position.y += 0.1f + bench_random_f32( rng ) * 2.0f;
+        actor_spawn(
+            actors, actors->count % 2 ? ACTOR_PROP : ACTOR_NPC, position,
+            PLAYER_CAPSULE_RADIUS, PLAYER_CAPSULE_HEIGHT );
+    }
+    result.spawned = actors->count;
+    physics_stats_reset( level->stats );
+
+    for( u32 step = 0; step < BENCH_ACTOR_STEPS; ++step ) {
+        f64 start = GetTime();
+        level_actors_step( level, actors, false, BENCH_ACTOR_DT );
+        f64 ms = ( GetTime() - start ) * 1000.0;
+
+        result.average_ms       += ms;
+        result.average_pairs    += actors->pair_count;
+        result.average_contacts += actors->contact_count;
+        if( ms > result.max_ms ) {
+            result.max_ms = ms;
+        }
+    }
+    result.average_ms       /= BENCH_ACTOR_STEPS;
+    result.average_pairs    /= BENCH_ACTOR_STEPS;
+    result.average_contacts /= BENCH_ACTOR_STEPS;
+    result.remaining         = actors->count;
+
+    actor_pool_clear( actors );
+    return result;
+}
+
+int tool_bench(void) {
+    struct SceneGame* scene = MemAlloc( sizeof(*scene) );
+    scene_game_load( scene );
+
+    struct Level* level = &scene->level;
+    if( !level->bvh.node_count ) {
+        TraceLog( LOG_ERROR, "Level has no colliders to benchmark!" );
+        scene_game_unload( scene );
+        MemFree( scene );
+        return -1;
+    }
+
+    int result = 0;
+    struct BenchReport report;
+    memset( &report, 0, sizeof(report) );
+
+    u32 triangle_count        = 0;
+    u32 source_triangle_count = 0;
+    usize collider_memory     = 0;
+    usize float_memory        = 0;
+    usize source_memory       = 0;
+    u32 sdf_count             = 0;
+    usize sdf_memory          = 0;
+    for( usize i = 0; i < level->object_count; ++i ) {
+        struct LevelObject* obj = level->objects + i;
+        if( obj->collider && !obj->collider_from_state ) {
+            triangle_count        += obj->collider->triangle_count;
+            source_triangle_count += obj->collider->source_triangle_count;
+            collider_memory       += collision_mesh_memory( obj->collider );
+            source_memory         += obj->collider->source_memory;
+            // NOTE(alicia): same mesh stored as f32 positions and u32 indices.
+            float_memory +=
+                sizeof(Vector3) * obj->collider->vertex_count +
+                sizeof(u32) * 3 * obj->collider->triangle_count +
+                sizeof(struct BVHNode) * obj->collider->node_count;
+        }
+        if( obj->type == LOT_STATIC && obj->t_static.sdf ) {
+            sdf_count++;
+            sdf_memory += collision_sdf_memory( obj->t_static.sdf );
+        }
+    }
+
+    bench_report( &report, "== physics benchmark ==" );
+    bench_report( &report, TextFormat(
+        "level: %u objects, %u collision triangles (%u before welding), %.2fKiB",
+        (u32)level->object_count, triangle_count, source_triangle_count,
+        collider_memory / 1024.0f ) );
+    bench_report( &report, TextFormat(
+        "collision storage: %.2fKiB quantized, %.2fKiB as f32 (%.2fx)",
+        collider_memory / 1024.0f, float_memory / 1024.0f,
+        collider_memory ? (f64)float_memory / (f64)collider_memory : 0.0 ) );
+    bench_report( &report, TextFormat(
+        "collision storage: %.2fKiB quantized, %.2fKiB as loaded meshes (%.2fx)",
+        collider_memory / 1024.0f, source_memory / 1024.0f,
+        collider_memory ? (f64)source_memory / (f64)collider_memory : 0.0 ) );
+
+    BoundingBox bounds = level->bvh.nodes[0].bounds;
+    Vector3 extent     = Vector3Subtract( bounds.max, bounds.min );
+
+    Vector3* positions = MemAlloc( sizeof(Vector3) * BENCH_CAPSULE_QUERIES );
+    u32 rng = BENCH_SEED;
+    for( u32 i = 0; i < BENCH_CAPSULE_QUERIES; ++i ) {
+        positions[i] = Vector3Add( bounds.min, Vector3Multiply( extent, v3(
+            bench_random_f32( &rng ),
+            bench_random_f32( &rng ),
+            bench_random_f32( &rng ) ) ) );
+    }
+
+    struct BenchCapsuleResult triangles = bench_capsule_queries(
+        level, positions, BENCH_CAPSULE_QUERIES, false );
+    bench_report( &report, TextFormat(
+        "capsule/triangles: %u queries, %u hits, %.3fms total, %.1fns/query",
+        BENCH_CAPSULE_QUERIES, triangles.hits, triangles.seconds * 1000.0,
+        triangles.seconds * 1e9 / BENCH_CAPSULE_QUERIES ) );
+    bench_report_counters( &report, level->stats, "capsule/triangles", "query", BENCH_CAPSULE_QUERIES );
+
+    struct BenchCapsuleResult jobs = bench_capsule_queries_jobs(
+        level, positions, BENCH_CAPSULE_QUERIES, false );
+    bench_report( &report, TextFormat(
+        "capsule/jobs:      %u queries, %u hits, %.3fms total, %.1fns/query "
+        "(%u threads, %.2fx)",
+        BENCH_CAPSULE_QUERIES, jobs.hits, jobs.seconds * 1000.0,
+        jobs.seconds * 1e9 / BENCH_CAPSULE_QUERIES, job_thread_count(),
+        jobs.seconds > 0.0 ? triangles.seconds / jobs.seconds : 0.0 ) );
+    bench_report_counters( &report, level->stats, "capsule/jobs", "query", BENCH_CAPSULE_QUERIES );
+
+    if( sdf_count ) {
+        struct BenchCapsuleResult sdf = bench_capsule_queries(
+            level, positions, BENCH_CAPSULE_QUERIES, true );
+        bench_report( &report, TextFormat(
+            "capsule/sdf:       %u queries, %u hits, %.3fms total, %.1fns/query",
+            BENCH_CAPSULE_QUERIES, sdf.hits, sdf.seconds * 1000.0,
+            sdf.seconds * 1e9 / BENCH_CAPSULE_QUERIES ) );
+        bench_report_counters( &report, level->stats, "capsule/sdf", "query", BENCH_CAPSULE_QUERIES );
+        bench_report( &report, TextFormat(
+            "sdf: %u static colliders, %.2fKiB", sdf_count, sdf_memory / 1024.0f ) );
+    } else {
+        bench_report( &report, "capsule/sdf: skipped, run --bake-sdf first" );
+    }
+
+    struct BenchActorResult crowd = bench_actors( level, &scene->actors, &rng );
+    bench_report( &report, TextFormat(
+        "actors: %u spawned, %u after %u steps, %.3fms/step avg, %.3fms max, "
+        "%.1f pairs, %.1f contacts",
+        crowd.spawned, crowd.remaining, BENCH_ACTOR_STEPS,
+        crowd.average_ms, crowd.max_ms,
+        crowd.average_pairs, crowd.average_contacts ) );
+    bench_report_counters( &report, level->stats, "actors", "step", BENCH_ACTOR_STEPS );
+
+    struct GameSnapshot snapshot;
+    memset( &snapshot, 0, sizeof(snapshot) );
+    f64 start = GetTime();
+    for( u32 i = 0; i < BENCH_SNAPSHOT_ITERATIONS; ++i ) {
+        scene_game_snapshot_take( scene, &snapshot );
+    }
+    f64 take_seconds = GetTime() - start;
+    start = GetTime();
+    for( u32 i = 0; i < BENCH_SNAPSHOT_ITERATIONS; ++i ) {
+        scene_game_snapshot_restore( scene, &snapshot );
+    }
+    f64 restore_seconds = GetTime() - start;
+    bench_report( &report, TextFormat(
+        "snapshot: %.2fKiB, %.2fus take, %.2fus restore",
+        snapshot.size / 1024.0f,
+        take_seconds * 1e6 / BENCH_SNAPSHOT_ITERATIONS,
+        restore_seconds * 1e6 / BENCH_SNAPSHOT_ITERATIONS ) );
+    scene_game_snapshot_free( &snapshot );
+
+    struct Rewind rewind;
+    rewind_create( &rewind );
+    struct Input input;
+    memset( &input, 0, sizeof(input) );
+    input.is_moving = true;
+    input.move      = v2( 0.0f, 1.0f );
+
+    f64 record_seconds = 0.0;
+    f64 record_max     = 0.0;
+    for( u32 i = 0; i < REWIND_HISTORY_TICKS; ++i ) {
+        input.jump = i % 60 == 0;
+        scene_game_tick( SIM_TICK_DT, scene, &input );
+
+        start = GetTime();
+        rewind_record( &rewind, scene );
+        f64 seconds = GetTime() - start;
+        record_seconds += seconds;
+        if( seconds > record_max ) {
+            record_max = seconds;
+        }
+    }
+    u32   rewind_ticks = rewind.entry_count;
+    usize rewind_bytes = rewind.bytes_used;
+
+    start = GetTime();
+    while( rewind_step( &rewind, scene ) ) {}
+    f64 step_seconds = GetTime() - start;
+
+    bench_report( &report, TextFormat(
+        "rewind: %u ticks in %.2fKiB, %.2fus/record avg, %.2fus max, %.2fus/step",
+        rewind_ticks, rewind_bytes / 1024.0f,
+        record_seconds * 1e6 / REWIND_HISTORY_TICKS, record_max * 1e6,
+        rewind_ticks ? step_seconds * 1e6 / rewind_ticks : 0.0 ) );
+    rewind_destroy( &rewind );
+
+    // NOTE(alicia): scene only keeps compressed clips,
+    // raylib's path needs its own full precision copy.
+    Model model = scene->model_player;
+    int anim_count = 0;
+    ModelAnimation* anims =
+        LoadModelAnimations( "resources/mesh/player.iqm", &anim_count );
+
+    if( scene->player_clip_count > PLAYER_RUN ) {
+        usize raw_memory  = 0;
+        usize clip_memory = 0;
+        f32 max_error[ANIM_CHANNEL_COUNT] = {0};
+        for( u32 i = 0; i < scene->player_clip_count && i < (u32)anim_count; ++i ) {
+            const struct AnimClip* clip = scene->player_clips + i;
+            raw_memory  += anim_raw_memory( anims[i] );
+            clip_memory += anim_clip_memory( clip );
+            for( u32 channel = 0; channel < ANIM_CHANNEL_COUNT; ++channel ) {
+                if( clip->max_error[channel] > max_error[channel] ) {
+                    max_error[channel] = clip->max_error[channel];
+                }
+            }
+        }
+
+        const struct AnimClip* clip = scene->player_clips + PLAYER_RUN;
+        Transform* pose = MemAlloc( sizeof(Transform) * ( clip->bone_count + 1 ) );
+        start = GetTime();
+        for( u32 i = 0; i < BENCH_SKIN_ITERATIONS; ++i ) {
+            anim_clip_sample( clip, (f32)i * BENCH_ACTOR_DT * 0.37f, pose );
+        }
+        f64 sample_seconds = GetTime() - start;
+        MemFree( pose );
+
+        bench_report( &report, TextFormat(
+            "anim clips: %.2fKiB packed, %.2fKiB unpacked (%.2fx), "
+            "max error %.5f rotation %.5f translation %.5f scale, %.2fus/sample",
+            clip_memory / 1024.0f, raw_memory / 1024.0f,
+            clip_memory ? (f64)raw_memory / (f64)clip_memory : 0.0,
+            max_error[ANIM_CHANNEL_ROTATION], max_error[ANIM_CHANNEL_TRANSLATION],
+            max_error[ANIM_CHANNEL_SCALE],
+            sample_seconds * 1e6 / BENCH_SKIN_ITERATIONS ) );
+    }
+
+    ModelAnimation anim = {0};
+    if( anim_count > PLAYER_RUN ) {
+        anim = anims[PLAYER_RUN];
+    }
+    if( scene->player_skin.mesh_count && anim.frameCount ) {
+        u32 vertex_count = 0;
+        for( u32 i = 0; i < scene->player_skin.mesh_count; ++i ) {
+            vertex_count += scene->player_skin.meshes[i].vertex_count;
+        }
+
+        start = GetTime();
+        for( u32 i = 0; i < BENCH_SKIN_ITERATIONS; ++i ) {
+            UpdateModelAnimation( model, anim, (int)( i % anim.frameCount ) );
+        }
+        f64 raylib_seconds = GetTime() - start;
+
+        start = GetTime();
+        for( u32 i = 0; i < BENCH_SKIN_ITERATIONS; ++i ) {
+            // NOTE(alicia): otherwise repeated frames would be skipped.
+            scene->player_skin.last_pose = NULL;
+            skin_model_animate(
+                &scene->player_skin, model, anim, (int)( i % anim.frameCount ) );
+        }
+        f64 skin_seconds = GetTime() - start;
+
+        bench_report( &report, TextFormat(
+            "skinning: %u vertices, %u bones, %.2fus/frame raylib, %.2fus/frame palette (%.2fx)",
+            vertex_count, scene->player_skin.bone_count,
+            raylib_seconds * 1e6 / BENCH_SKIN_ITERATIONS,
+            skin_seconds * 1e6 / BENCH_SKIN_ITERATIONS,
+            skin_seconds > 0.0 ? raylib_seconds / skin_seconds : 0.0 ) );
+
+        // NOTE(alicia): both paths write animVertices/animNormals,
+        // keep raylib's result aside and compare every frame.
+        f32* expected = MemAlloc( sizeof(f32) * 3 * vertex_count * 2 );
+        f32 position_error = 0.0f;
+        f32 normal_error   = 0.0f;
+        for( int frame = 0; frame < anim.frameCount; ++frame ) {
+            UpdateModelAnimation( model, anim, frame );
+            f32* at = expected;
+            for( u32 j = 0; j < scene->player_skin.mesh_count; ++j ) {
+                const struct SkinMesh* skin_mesh = scene->player_skin.meshes + j;
+                usize count = (usize)skin_mesh->vertex_count * 3;
+                memcpy( at, model.meshes[j].animVertices, sizeof(f32) * count );
+                at += count;
+                if( skin_mesh->normals ) {
+                    memcpy( at, model.meshes[j].animNormals, sizeof(f32) * count );
+                    at += count;
+                }
+            }
+
+            scene->player_skin.last_pose = NULL;
+            skin_model_animate( &scene->player_skin, model, anim, frame );
+            at = expected;
+            for( u32 j = 0; j < scene->player_skin.mesh_count; ++j ) {
+                const struct SkinMesh* skin_mesh = scene->player_skin.meshes + j;
+                usize count = (usize)skin_mesh->vertex_count * 3;
+                for( usize k = 0; k < count; ++k ) {
+                    f32 error = absf( model.meshes[j].animVertices[k] - at[k] );
+                    position_error = error > position_error ? error : position_error;
+                }
+                at += count;
+                if( skin_mesh->normals ) {
+                    for( usize k = 0; k < count; ++k ) {
+                        f32 error = absf( model.meshes[j].animNormals[k] - at[k] );
+                        normal_error = error > normal_error ? error : normal_error;
+                    }
+                    at += count;
+                }
+            }
+        }
+        MemFree( expected );
+
+        b32 skin_matches =
+            position_error <= BENCH_SKIN_EPSILON && normal_error <= BENCH_SKIN_EPSILON;
+        bench_report( &report, TextFormat(
+            "skinning: max error %.7f position %.7f normal against raylib, %s",
+            position_error, normal_error, skin_matches ? "ok" : "FAILED" ) );
+        if( !skin_matches ) {
+            TraceLog( LOG_ERROR, "Palette skinning does not match UpdateModelAnimation!" );
+            result = 1;
+        }
+
+        struct SkinCache cache;
+        start = GetTime();
+        skin_cache_bake(
+            &scene->player_skin, model,
+            scene->player_clips, scene->player_clip_count, &cache );
+        f64 bake_seconds = GetTime() - start;
+
+        start = GetTime();
+        for( u32 i = 0; i < BENCH_SKIN_ITERATIONS; ++i ) {
+            cache.last_frame = U32_MAX;
+            skin_cache_play( &cache, model, PLAYER_RUN, (int)i );
+        }
+        f64 play_seconds = GetTime() - start;
+
+        // NOTE(alicia): palette and cache both re-upload every
+        // frame, time upload alone to see what cache actually saves.
+        start = GetTime();
+        for( u32 i = 0; i < BENCH_SKIN_ITERATIONS; ++i ) {
+            for( u32 j = 0; j < scene->player_skin.mesh_count; ++j ) {
+                const struct SkinMesh* skin_mesh = scene->player_skin.meshes + j;
+                if( !skin_mesh->vertex_count ) {
+                    continue;
+                }
+                Mesh  mesh = model.meshes[j];
+                usize size = sizeof(f32) * 3 * (usize)mesh.vertexCount;
+                UpdateMeshBuffer( mesh, 0, mesh.animVertices, (int)size, 0 );
+                if( skin_mesh->normals ) {
+                    UpdateMeshBuffer( mesh, 2, mesh.animNormals, (int)size, 0 );
+                }
+            }
+        }
+        f64 upload_seconds = GetTime() - start;
+
+        bench_report( &report, TextFormat(
+            "frame cache: %u frames, %.2fKiB (%.2fKiB as f32), %.2fms bake, "
+            "%.2fus/frame play (%.2fx palette)",
+            cache.frame_count, skin_cache_memory( &cache ) / 1024.0f,
+            skin_cache_raw_memory( &cache ) / 1024.0f, bake_seconds * 1000.0,
+            play_seconds * 1e6 / BENCH_SKIN_ITERATIONS,
+            play_seconds > 0.0 ? skin_seconds / play_seconds : 0.0 ) );
+        f64 skin_only = skin_seconds - upload_seconds;
+        f64 play_only = play_seconds - upload_seconds;
+        bench_report( &report, TextFormat(
+            "frame cache: %.2fus/frame upload in both, "
+            "%.2fus/frame palette math vs %.2fus/frame decode (%.2fx)",
+            upload_seconds * 1e6 / BENCH_SKIN_ITERATIONS,
+            skin_only * 1e6 / BENCH_SKIN_ITERATIONS,
+            play_only * 1e6 / BENCH_SKIN_ITERATIONS,
+            play_only > 0.0 ? skin_only / play_only : 0.0 ) );
+        skin_cache_destroy( &cache );
+    }
+    UnloadModelAnimations( anims, anim_count );
+
+    MemFree( positions );
+    scene_game_unload( scene );
+    MemFree( scene );
+
+    if( !SaveFileText( BENCH_REPORT_PATH, report.text ) ) {
+        TraceLog( LOG_WARNING, "Failed to write %s!", BENCH_REPORT_PATH );
+        return -1;
+    }
+    return result;
+}
+
+int tool_bake_sdf(void) {
+    struct SceneGame* scene = MemAlloc( sizeof(*scene) );
+    scene->bake_sdf = true;
+    scene_game_load( scene );
+    scene_game_unload( scene );
+    MemFree( scene );
+    return 0;
+}
+
+struct BatchSession {
+    u32 seed;
+    u32 ticks;
+    u64 hash;
+    u32 deaths;
+    b32 won;
+    b32 diverged;
+};
+struct Batch {
+    const struct SceneGame* source;
+    const struct Replay*    replay;
+    struct BatchSession*    sessions;
+};
+
+static void batch_random_input( u32* rng, u32 tick, struct Input* input ) {
+    // NOTE(alicia): hold movement for a while so
+    // sessions actually travel instead of jittering.
+    if( tick % BATCH_INPUT_HOLD_TICKS == 0 ) {
+        input->move = v2(
+            bench_random_f32( rng ) * 2.0f - 1.0f,
+            bench_random_f32( rng ) * 2.0f - 1.0f );
+        input->move        = Vector2ClampValue( input->move, 0.0f, 1.0f );
+        input->is_moving   = bench_random( rng ) % 4 != 0;
+        input->run_hold    = bench_random( rng ) % 2;
+        input->resize_hold = bench_random( rng ) % 3 == 0;
+        input->jump_hold   = bench_random( rng ) % 2;
+    }
+    input->jump     = bench_random( rng ) % 24 == 0;
+    input->rotation = v2(
+        ( bench_random_f32( rng ) * 2.0f - 1.0f ) * 40.0f,
+        ( bench_random_f32( rng ) * 2.0f - 1.0f ) * 10.0f );
+}
+
+static void batch_session_range( void* params, u32 begin, u32 end, u32 thread ) {
+    unused( thread );
+    struct Batch* batch = params;
+
+    struct SceneGame* instance = MemAlloc( sizeof(*instance) );
+    for( u32 i = begin; i < end; ++i ) {
+        struct BatchSession* session = batch->sessions + i;
+        scene_game_instance_create( batch->source, instance );
+        if( batch->replay ) {
+            // NOTE(alicia): recording may have rewound,
+            // which needs history to match its hashes.
+            rewind_create( &instance->rewind );
+        }
+        float_env_init();
+
+        u32 rng = session->seed;
+        u32 max_ticks = batch->replay ? batch->replay->frame_count : BATCH_MAX_TICKS;
+
+        struct Input input;
+        memset( &input, 0, sizeof(input) );
+        for( u32 tick = 0; tick < max_ticks; ++tick ) {
+            if( batch->replay ) {
+                input = batch->replay->frames[tick].input;
+            } else {
+                batch_random_input( &rng, tick, &input );
+            }
+
+            u32 events = scene_game_tick( SIM_TICK_DT, instance, &input );
+            session->ticks++;
+            session->hash = scene_game_hash( instance );
+
+            if( batch->replay && session->hash != batch->replay->frames[tick].hash ) {
+                session->diverged = true;
+                break;
+            }
+            if( events & GAME_EVENT_DIED ) {
+                session->deaths++;
+            }
+            if( events & GAME_EVENT_EXIT ) {
+                break;
+            }
+        }
+
+        session->won = instance->player.won;
+        scene_game_instance_destroy( instance );
+    }
+    MemFree( instance );
+}
+
+int tool_batch( const char* opt_replay_path ) {
+    struct Replay replay;
+    memset( &replay, 0, sizeof(replay) );
+    if( opt_replay_path ) {
+        if( !replay_load( opt_replay_path, &replay ) ) {
+            TraceLog( LOG_ERROR, "Failed to load replay %s!", opt_replay_path );
+            return -1;
+        }
+        if( replay.tick_dt != SIM_TICK_DT ) {
+            TraceLog( LOG_ERROR,
+                "Replay %s was recorded at a different tick rate!", opt_replay_path );
+            replay_free( &replay );
+            return -1;
+        }
+    }
+
+    struct SceneGame* scene = MemAlloc( sizeof(*scene) );
+    scene_game_load( scene );
+
+    struct Batch batch;
+    batch.source   = scene;
+    batch.replay   = opt_replay_path ? &replay : NULL;
+    batch.sessions = MemAlloc( sizeof(struct BatchSession) * BATCH_SESSION_COUNT );
+    memset( batch.sessions, 0, sizeof(struct BatchSession) * BATCH_SESSION_COUNT );
+
+    u32 rng = BENCH_SEED;
+    for( u32 i = 0; i < BATCH_SESSION_COUNT; ++i ) {
+        batch.sessions[i].seed = bench_random( &rng );
+    }
+
+    f64 start = GetTime();
+    job_parallel_for( BATCH_SESSION_COUNT, 1, batch_session_range, &batch );
+    f64 seconds = GetTime() - start;
+
+    u64 ticks    = 0;
+    u32 deaths   = 0;
+    u32 won      = 0;
+    u32 diverged = 0;
+    for( u32 i = 0; i < BATCH_SESSION_COUNT; ++i ) {
+        struct BatchSession* session = batch.sessions + i;
+        ticks    += session->ticks;
+        deaths   += session->deaths;
+        won      += session->won ? 1 : 0;
+        diverged += session->diverged ? 1 : 0;
+    }
+
+    struct BenchReport report;
+    memset( &report, 0, sizeof(report) );
+    bench_report( &report, "== batch simulation ==" );
+    bench_report( &report, TextFormat(
+        "input: %s", opt_replay_path ? opt_replay_path : "random" ) );
+    bench_report( &report, TextFormat(
+        "%u sessions, %llu ticks, %.3fs on %u threads",
+        BATCH_SESSION_COUNT, (unsigned long long)ticks, seconds, job_thread_count() ) );
+    bench_report( &report, TextFormat(
+        "throughput: %.2f sessions/s, %.0f ticks/s",
+        seconds > 0.0 ? BATCH_SESSION_COUNT / seconds : 0.0,
+        seconds > 0.0 ? (f64)ticks / seconds : 0.0 ) );
+    bench_report( &report, TextFormat(
+        "outcome: %u won, %u ran out of ticks, %u deaths total",
+        won, BATCH_SESSION_COUNT - won, deaths ) );
+    if( opt_replay_path ) {
+        bench_report( &report, TextFormat(
+            "replay: %u of %u sessions diverged", diverged, BATCH_SESSION_COUNT ) );
+    }
+
+    MemFree( batch.sessions );
+    scene_game_unload( scene );
+    MemFree( scene );
+    replay_free( &replay );
+
+    if( !SaveFileText( BATCH_REPORT_PATH, report.text ) ) {
+        TraceLog( LOG_WARNING, "Failed to write %s!", BATCH_REPORT_PATH );
+        return -1;
+    }
+    return diverged ? 1 : 0;
+}
+
+enum FuzzFailure {
+    FUZZ_OK,
+    FUZZ_INSIDE_GEOMETRY,
+    FUZZ_FELL_THROUGH,
+    FUZZ_STUCK,
+
+    FUZZ_FAILURE_COUNT
+};
+static const char* fuzz_failure_name( enum FuzzFailure failure ) {
+    switch( failure ) {
+        case FUZZ_OK:              return "ok";
+        case FUZZ_INSIDE_GEOMETRY: return "inside";
+        case FUZZ_FELL_THROUGH:    return "fell";
+        case FUZZ_STUCK:           return "stuck";
+        case FUZZ_FAILURE_COUNT:   break;
+    }
+    return "unknown";
+}
+
+struct FuzzSession {
+    u32 seed;
+    b32 biased;
+    u32 ticks;
+
+    enum FuzzFailure failure;
+    u32 failure_tick;
+    struct Replay replay;
+};
+struct Fuzz {
+    const struct SceneGame* source;
+    struct FuzzSession*     sessions;
+};
+
+/// Mostly forward and running with frequent jumps and resizes,
+/// reaches ledges and platform edges far more often than uniform input.
+static void fuzz_biased_input( u32* rng, u32 tick, struct Input* input ) {
+    if( tick % BATCH_INPUT_HOLD_TICKS == 0 ) {
+        input->move = v2(
+            ( bench_random_f32( rng ) * 2.0f - 1.0f ) * 0.5f,
+            bench_random( rng ) % 8 ? 1.0f : -1.0f );
+        input->move        = Vector2ClampValue( input->move, 0.0f, 1.0f );
+        input->is_moving   = true;
+        input->run_hold    = bench_random( rng ) % 4 != 0;
+        input->resize_hold = bench_random( rng ) % 2;
+        input->jump_hold   = bench_random( rng ) % 4 != 0;
+    }
+    input->jump     = bench_random( rng ) % 12 == 0;
+    input->rotation = v2(
+        ( bench_random_f32( rng ) * 2.0f - 1.0f ) * 20.0f, 0.0f );
+}
+
+static void fuzz_session_range( void* params, u32 begin, u32 end, u32 thread ) {
+    unused( thread );
+    struct Fuzz* fuzz = params;
+
+    struct SceneGame* instance = MemAlloc( sizeof(*instance) );
+    for( u32 i = begin; i < end; ++i ) {
+        struct FuzzSession* session = fuzz->sessions + i;
+        scene_game_instance_create( fuzz->source, instance );
+        replay_begin( &session->replay, instance->current_level, SIM_TICK_DT );
+        float_env_init();
+
+        u32 rng = session->seed;
+        u32 inside_ticks = 0;
+        u32 below_ticks  = 0;
+        u32 stuck_ticks  = 0;
+        Vector3 stuck_anchor = instance->player.transform.translation;
+
+        struct Input input;
+        memset( &input, 0, sizeof(input) );
+        for( u32 tick = 0; tick < FUZZ_MAX_TICKS && !session->failure; ++tick ) {
+            if( session->biased ) {
+                fuzz_biased_input( &rng, tick, &input );
+            } else {
+                batch_random_input( &rng, tick, &input );
+            }
+
+            replay_keyframe( &session->replay, instance );
+            u32 events = scene_game_tick( SIM_TICK_DT, instance, &input );
+            replay_push( &session->replay, &input, scene_game_hash( instance ) );
+            session->ticks++;
+
+            const struct Player* player = &instance->player;
+            if( events & GAME_EVENT_EXIT ) {
+                break;
+            }
+            if( player->is_dead || player->won ) {
+                inside_ticks = below_ticks = stuck_ticks = 0;
+                stuck_anchor = player->transform.translation;
+                continue;
+            }
+
+            Vector3 start = player->transform.translation;
+            Vector3 end   = Vector3Add( start, v3( 0.0f, PLAYER_CAPSULE_HEIGHT, 0.0f ) );
+            struct CollisionResult inside = level_capsule_query(
+                &instance->level, start, end, PLAYER_CAPSULE_RADIUS,
+                instance->use_sdf, NULL );
+            inside_ticks = inside.hit && inside.distance > FUZZ_INSIDE_DEPTH ?
+                inside_ticks + 1 : 0;
+
+            b32 below =
+                instance->level.bvh.node_count &&
+                start.y < instance->level.bvh.nodes[0].bounds.min.y;
+            below_ticks = below ? below_ticks + 1 : 0;
+
+            b32 trying = player->input.is_moving || player->input.jump;
+            if(
+                trying && !player->is_grounded &&
+                Vector3Distance( start, stuck_anchor ) < FUZZ_STUCK_DISTANCE
+            ) {
+                stuck_ticks++;
+            } else {
+                stuck_ticks  = 0;
+                stuck_anchor = start;
+            }
+
+            if( inside_ticks >= FUZZ_INSIDE_TICKS ) {
+                session->failure = FUZZ_INSIDE_GEOMETRY;
+            } else if( below_ticks >= FUZZ_FALL_TICKS ) {
+                session->failure = FUZZ_FELL_THROUGH;
+            } else if( stuck_ticks >= FUZZ_STUCK_TICKS ) {
+                session->failure = FUZZ_STUCK;
+            }
+            session->failure_tick = tick;
+        }
+
+        // NOTE(alicia): only failures are kept for saving.
+        if( !session->failure ) {
+            replay_free( &session->replay );
+        }
+        scene_game_instance_destroy( instance );
+    }
+    MemFree( instance );
+}
+
+int tool_fuzz( u32 seed ) {
+    struct SceneGame* scene = MemAlloc( sizeof(*scene) );
+    scene_game_load( scene );
+
+    struct Fuzz fuzz;
+    fuzz.source   = scene;
+    fuzz.sessions = MemAlloc( sizeof(struct FuzzSession) * FUZZ_SESSION_COUNT );
+    memset( fuzz.sessions, 0, sizeof(struct FuzzSession) * FUZZ_SESSION_COUNT );
+
+    u32 rng = seed ? seed : BENCH_SEED;
+    for( u32 i = 0; i < FUZZ_SESSION_COUNT; ++i ) {
+        fuzz.sessions[i].seed   = bench_random( &rng );
+        fuzz.sessions[i].biased = i % 2;
+    }
+
+    f64 start = GetTime();
+    job_parallel_for( FUZZ_SESSION_COUNT, 1, fuzz_session_range, &fuzz );
+    f64 seconds = GetTime() - start;
+
+    struct BenchReport report;
+    memset( &report, 0, sizeof(report) );
+    bench_report( &report, "== fuzz ==" );
+
+    u64 ticks = 0;
+    u32 failures[FUZZ_FAILURE_COUNT];
+    memset( failures, 0, sizeof(failures) );
+    for( u32 i = 0; i < FUZZ_SESSION_COUNT; ++i ) {
+        struct FuzzSession* session = fuzz.sessions + i;
+        ticks += session->ticks;
+        failures[session->failure]++;
+        if( !session->failure ) {
+            continue;
+        }
+
+        const char* path = TextFormat( "fuzz_%s_%08x.grec",
+            fuzz_failure_name( session->failure ), session->seed );
+        b32 saved = replay_save( &session->replay, path );
+        bench_report( &report, TextFormat(
+            "%s: seed 0x%08x (%s input) at tick %u -> %s",
+            fuzz_failure_name( session->failure ), session->seed,
+            session->biased ? "biased" : "random", session->failure_tick,
+            saved ? path : "failed to save replay" ) );
+        replay_free( &session->replay );
+    }
+
+    bench_report( &report, TextFormat(
+        "seed 0x%08x: %u sessions, %llu ticks, %.3fs on %u threads, "
+        "%.2f sessions/s, %.0f ticks/s",
+        seed, FUZZ_SESSION_COUNT, (unsigned long long)ticks, seconds, job_thread_count(),
+        seconds > 0.0 ? FUZZ_SESSION_COUNT / seconds : 0.0,
+        seconds > 0.0 ? (f64)ticks / seconds : 0.0 ) );
+    bench_report( &report, TextFormat(
+        "failures: %u inside geometry, %u fell through, %u stuck",
+        failures[FUZZ_INSIDE_GEOMETRY], failures[FUZZ_FELL_THROUGH],
+        failures[FUZZ_STUCK] ) );
+
+    u32 failure_count = FUZZ_SESSION_COUNT - failures[FUZZ_OK];
+    MemFree( fuzz.sessions );
+    scene_game_unload( scene );
+    MemFree( scene );
+
+    if( !SaveFileText( FUZZ_REPORT_PATH, report.text ) ) {
+        TraceLog( LOG_WARNING, "Failed to write %s!", FUZZ_REPORT_PATH );
+        return -1;
+    }
+    return failure_count ? 1 : 0;
+}
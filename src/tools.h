@@ -0,0 +1,60 @@
+#if !defined(TOOLS_H)
+#define TOOLS_H
+/**
+ * @file   tools.h
+ * @brief  Command line tools.
+ * @author Alicia Amarilla (smushyaa@gmail.com)
+ * @date   October 18, 2026
+*/
+#include "common.h"
+
+#define BENCH_REPORT_PATH "bench_report.txt"
+#define BENCH_CAPSULE_QUERIES (20000)
+#define BENCH_SEED (0x9E3779B9)
+#define BENCH_ACTOR_COUNT (2000)
+#define BENCH_ACTOR_STEPS (240)
+#define BENCH_ACTOR_DT    (1.0f / 60.0f)
+#define BENCH_SNAPSHOT_ITERATIONS (1000)
+/// Player frames skinned by each skinning path.
+#define BENCH_SKIN_ITERATIONS (600)
+/// Largest difference from UpdateModelAnimation's vertices and normals
+/// the palette path may have before --bench fails.
+#define BENCH_SKIN_EPSILON (1e-4f)
+
+#define BATCH_REPORT_PATH "batch_report.txt"
+#define BATCH_SESSION_COUNT (256)
+/// Random input sessions that don't finish the level stop here.
+#define BATCH_MAX_TICKS (60 * 60)
+/// Ticks random movement, run and resize input is held for.
+#define BATCH_INPUT_HOLD_TICKS (30)
+
+#define FUZZ_REPORT_PATH "fuzz_report.txt"
+#define FUZZ_SESSION_COUNT (1024)
+#define FUZZ_MAX_TICKS (60 * 30)
+/// Capsule counts as inside geometry past this penetration depth . . .
+#define FUZZ_INSIDE_DEPTH (PLAYER_CAPSULE_RADIUS)
+/// . . . for this many ticks in a row.
+#define FUZZ_INSIDE_TICKS (5)
+/// Ticks player may spend below every collider without dying.
+#define FUZZ_FALL_TICKS (60 * 3)
+/// Airborne player that moves less than this over
+/// FUZZ_STUCK_TICKS while trying to move is stuck.
+#define FUZZ_STUCK_DISTANCE (0.05f)
+#define FUZZ_STUCK_TICKS (60 * 2)
+
+/// Run physics benchmark on level 0 and write report to BENCH_REPORT_PATH.
+int tool_bench(void);
+/// Bake SDFs for every static collider in level 0.
+int tool_bake_sdf(void);
+/// Run BATCH_SESSION_COUNT headless sessions of level 0 across job system
+/// and write throughput to BATCH_REPORT_PATH. Sessions play opt_replay_path
+/// and verify its hashes if given, random input otherwise.
+/// Returns 1 if any replayed session diverged.
+int tool_batch( const char* opt_replay_path );
+/// Run FUZZ_SESSION_COUNT sessions of level 0 with random and biased input
+/// derived from seed, looking for capsules inside geometry, falls below
+/// every collider without a kill and stuck players. Every failure is saved
+/// as a replay next to FUZZ_REPORT_PATH. Returns 1 if anything was found.
+int tool_fuzz( u32 seed );
+
+#endif /* header guard */